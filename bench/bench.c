@@ -0,0 +1,86 @@
+/*
+ * Timing and reporting shared by all the benchmarks
+ */
+#include "minieap_common.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_RDTSC
+#endif
+
+uint64_t bench_now_nsecs() {
+    struct timespec _ts;
+    clock_gettime(CLOCK_MONOTONIC, &_ts);
+    return (uint64_t)_ts.tv_sec * 1000000000ULL + _ts.tv_nsec;
+}
+
+#ifdef BENCH_HAS_RDTSC
+uint64_t bench_now_cycles() {
+    return __rdtsc();
+}
+
+int bench_cycles_counted() {
+    return TRUE;
+}
+#else
+uint64_t bench_now_cycles() {
+    return 0;
+}
+
+int bench_cycles_counted() {
+    return FALSE;
+}
+#endif
+
+void bench_run(void (*op)(void* ctx), void* ctx, BENCH_RESULT* result) {
+    uint64_t _n, _i, _start, _elapsed, _alloc_start, _cycles_start;
+
+    /* Double the iterations until one round takes long enough */
+    for (_n = 1; ; _n <<= 1) {
+        _alloc_start = bench_alloc_count();
+        _cycles_start = bench_now_cycles();
+        _start = bench_now_nsecs();
+        for (_i = 0; _i < _n; ++_i) {
+            op(ctx);
+        }
+        _elapsed = bench_now_nsecs() - _start;
+        result->cycles = bench_now_cycles() - _cycles_start;
+        if (_elapsed >= BENCH_MIN_NSECS) {
+            break;
+        }
+    }
+    result->iterations = _n;
+    result->nsecs = _elapsed;
+    result->allocs = bench_alloc_count() - _alloc_start;
+    result->ns_per_op = (double)_elapsed / _n;
+}
+
+void bench_print_result(const char** sep, const char* name, const BENCH_RESULT* result,
+                        const char* golden, const char* extra_fmt, ...) {
+    va_list _args;
+
+    printf("%s\n    {\"name\": \"%s\", ", *sep, name);
+    if (result != NULL) {
+        printf("\"iterations\": %llu, \"ns_per_op\": %.1f, ",
+               (unsigned long long)result->iterations, result->ns_per_op);
+        if (bench_alloc_counted()) {
+            printf("\"allocs_per_op\": %.2f, ", (double)result->allocs / result->iterations);
+        } else {
+            printf("\"allocs_per_op\": null, ");
+        }
+    }
+    if (extra_fmt != NULL) {
+        va_start(_args, extra_fmt);
+        vprintf(extra_fmt, _args);
+        va_end(_args);
+        printf(", ");
+    }
+    printf("\"golden\": \"%s\"}", golden);
+    fflush(stdout);
+    *sep = ",";
+}
@@ -0,0 +1,82 @@
+#ifndef _MINIEAP_BENCH_H
+#define _MINIEAP_BENCH_H
+
+#include <stdint.h>
+
+#define BENCH_MIN_NSECS 100000000ULL /* 100ms */
+#define DEFAULT_CORPUS_DIR "bench/corpus"
+
+uint64_t bench_now_nsecs();
+
+/*
+ * CPU cycle counter (rdtsc), where there is one.
+ * `bench_cycles_counted` tells whether that is the case, otherwise this returns 0.
+ */
+uint64_t bench_now_cycles();
+int bench_cycles_counted();
+
+typedef struct _bench_result {
+    uint64_t iterations;
+    uint64_t nsecs; /* Taken by all the iterations */
+    uint64_t allocs; /* Made by all the iterations */
+    uint64_t cycles; /* Taken by all the iterations, 0 if not counted */
+    double ns_per_op;
+} BENCH_RESULT;
+
+/*
+ * Call `op` with `ctx` over and over, doubling the iterations until one round
+ * takes at least BENCH_MIN_NSECS, and measure that round
+ */
+void bench_run(void (*op)(void* ctx), void* ctx, BENCH_RESULT* result);
+
+/*
+ * Print a JSON object of the "benchmarks" array, prefixed by `*sep`, which is
+ * updated afterwards. `result` may be NULL if the case was not run.
+ * `extra_fmt` (printf format, NULL = none) adds fields specific to the case,
+ * e.g. "\"bytes\": %d".
+ */
+void bench_print_result(const char** sep, const char* name, const BENCH_RESULT* result,
+                        const char* golden, const char* extra_fmt, ...);
+
+/*
+ * Number of malloc/calloc/realloc/strdup calls made by minieap code so far.
+ * Only counted where the linker can wrap them (see minieap.mk),
+ * `bench_alloc_counted` tells whether that is the case.
+ */
+uint64_t bench_alloc_count();
+int bench_alloc_counted();
+
+/*
+ * Replay the frames in `corpus_dir` through the RJv3 TLV code.
+ * Results are printed as JSON objects of the "benchmarks" array, each one
+ * prefixed by `*sep`, which is updated afterwards.
+ * With `regen`, expected outputs are written instead of checked.
+ *
+ * Return: number of golden check failures
+ */
+int run_tlv_benchmarks(const char* filter, const char* corpus_dir, int regen, const char** sep);
+
+/*
+ * Check and time the DNS cache with a resolv.conf that is replaced once.
+ * Results are printed in the same way as above.
+ *
+ * Return: number of failed checks
+ */
+int run_dns_benchmarks(const char* filter, const char** sep);
+
+/*
+ * Compare per-frame send/recv with sendmmsg/recvmmsg on a socketpair.
+ * Results are printed in the same way as above.
+ *
+ * Return: number of failed checks
+ */
+int run_sock_benchmarks(const char* filter, const char** sep);
+
+/*
+ * Compare the Whirlpool block function with the one before it was optimized.
+ * Results are printed in the same way as above.
+ *
+ * Return: number of messages whose digests differ
+ */
+int run_whirlpool_benchmarks(const char* filter, const char** sep);
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Count allocations by wrapping the allocator with `ld --wrap`.
+ * Only calls from our own objects are redirected here, allocations inside libc are not counted.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t g_alloc_count;
+
+#ifdef BENCH_WRAP_ALLOC
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+char* __real_strdup(const char* s);
+
+void* __wrap_malloc(size_t size) {
+    g_alloc_count++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size) {
+    g_alloc_count++;
+    return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    g_alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+char* __wrap_strdup(const char* s) {
+    g_alloc_count++;
+    return __real_strdup(s);
+}
+
+int bench_alloc_counted() {
+    return TRUE;
+}
+#else
+int bench_alloc_counted() {
+    return FALSE;
+}
+#endif
+
+uint64_t bench_alloc_count() {
+    return g_alloc_count;
+}
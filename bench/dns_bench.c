@@ -0,0 +1,183 @@
+/*
+ * Lookups through the DNS cache, which is checked before every RJv3 frame
+ *
+ * A resolv.conf in a temporary directory, linked from another one as on
+ * OpenWrt, is replaced once by rename(). The cache should be reloaded for
+ * that exactly once, and never again while it is looked up afterwards.
+ * Anything else is reported as a golden check failure.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+#include "logging.h"
+#include "linkedlist.h"
+#include "net_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#define DNS_BENCH_DIR_TEMPLATE "/tmp/minieap_bench.XXXXXX"
+
+static char g_dir[sizeof(DNS_BENCH_DIR_TEMPLATE)];
+
+static void dns_bench_path(char* buf, const char* name) {
+    snprintf(buf, PATH_MAX, "%s/%s", g_dir, name);
+}
+
+static RESULT write_file(const char* name, const char* content) {
+    char _path[PATH_MAX];
+    FILE* _fp;
+
+    dns_bench_path(_path, name);
+    if ((_fp = fopen(_path, "w")) == NULL) {
+        PR_ERRNO("无法写入测试文件");
+        return FAILURE;
+    }
+    fputs(content, _fp);
+    fclose(_fp);
+    return SUCCESS;
+}
+
+/* link/resolv.conf -> ../real/resolv.conf */
+static RESULT setup_files() {
+    char _path[PATH_MAX];
+
+    strcpy(g_dir, DNS_BENCH_DIR_TEMPLATE);
+    if (mkdtemp(g_dir) == NULL) {
+        PR_ERRNO("无法创建临时目录");
+        return FAILURE;
+    }
+
+    dns_bench_path(_path, "link");
+    mkdir(_path, 0700);
+    dns_bench_path(_path, "real");
+    mkdir(_path, 0700);
+    dns_bench_path(_path, "link/resolv.conf");
+    if (symlink("../real/resolv.conf", _path) < 0) {
+        PR_ERRNO("无法创建符号链接");
+        return FAILURE;
+    }
+    return write_file("real/resolv.conf", "nameserver 10.0.0.1\nnameserver 10.0.0.2\n");
+}
+
+static void remove_files() {
+    static const char* _names[] = {"link/resolv.conf", "real/resolv.conf", "real/resolv.conf.new"};
+    char _path[PATH_MAX];
+    int i;
+
+    for (i = 0; i < sizeof(_names) / sizeof(char*); ++i) {
+        dns_bench_path(_path, _names[i]);
+        unlink(_path);
+    }
+    dns_bench_path(_path, "link");
+    rmdir(_path);
+    dns_bench_path(_path, "real");
+    rmdir(_path);
+    rmdir(g_dir);
+}
+
+/* Replaced as resolvconf and netifd do */
+static RESULT replace_file() {
+    char _from[PATH_MAX], _to[PATH_MAX];
+
+    if (IS_FAIL(write_file("real/resolv.conf.new", "nameserver 10.0.0.3\nnameserver 10.0.0.4\n"))) {
+        return FAILURE;
+    }
+    dns_bench_path(_from, "real/resolv.conf.new");
+    dns_bench_path(_to, "real/resolv.conf");
+    if (rename(_from, _to) < 0) {
+        PR_ERRNO("无法替换测试文件");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static int second_dns_is(const char* expected) {
+    LIST_ELEMENT* _list = NULL;
+    int _ret;
+
+    _ret = !IS_FAIL(obtain_dns_list(&_list)) && _list != NULL && _list->next != NULL
+            && strcmp(_list->next->content, expected) == 0;
+    free_dns_list(&_list);
+    return _ret;
+}
+
+static const char* check_reload() {
+    char _path[PATH_MAX];
+    uint32_t _gen;
+
+    dns_bench_path(_path, "link/resolv.conf");
+    if (IS_FAIL(dns_cache_init(_path))) {
+        return "error";
+    }
+
+    _gen = dns_cache_generation();
+    if (_gen == 0 || !second_dns_is("10.0.0.2")) {
+        PR_ERR("DNS 缓存初始内容错误");
+        return "mismatch";
+    }
+
+    if (IS_FAIL(replace_file())) {
+        return "error";
+    }
+    if (dns_cache_generation() == _gen || !second_dns_is("10.0.0.4")) {
+        PR_ERR("替换 %s 后 DNS 缓存未更新", _path);
+        return "mismatch";
+    }
+
+    /* Reloading must not make itself stale again */
+    _gen = dns_cache_generation();
+    if (dns_cache_generation() != _gen) {
+        PR_ERR("DNS 缓存在文件未改变时重新读取");
+        return "reloaded";
+    }
+    return "ok";
+}
+
+static void op_check(void* ctx) {
+    dns_cache_generation();
+}
+
+int run_dns_benchmarks(const char* filter, const char** sep) {
+    BENCH_RESULT _result;
+    uint32_t _gen;
+    const char* _golden;
+
+    if (filter != NULL && strstr("dns/check", filter) == NULL) {
+        return 0;
+    }
+
+    if (IS_FAIL(setup_files())) {
+        return 1;
+    }
+    _golden = check_reload();
+    if (strcmp(_golden, "ok") != 0) {
+        dns_cache_destroy();
+        remove_files();
+        bench_print_result(sep, "dns/check", NULL, _golden, NULL);
+        return 1;
+    }
+
+    _gen = dns_cache_generation();
+    bench_run(op_check, NULL, &_result);
+    if (dns_cache_generation() != _gen) {
+        PR_ERR("DNS 缓存在文件未改变时重新读取");
+        _golden = "reloaded";
+    }
+
+    dns_cache_destroy();
+    remove_files();
+
+    bench_print_result(sep, "dns/check", &_result, _golden, NULL);
+    return strcmp(_golden, "ok") != 0;
+}
+#else
+int run_dns_benchmarks(const char* filter, const char** sep) {
+    return 0;
+}
+#endif
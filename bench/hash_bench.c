@@ -0,0 +1,275 @@
+/*
+ * Microbenchmark of the hashing / encoding code on the RJv3 hot path
+ *
+ * Each case runs once on a fixed input and checks the output against a golden
+ * vector, which was produced by the original (unoptimized) code. This catches
+ * any optimization that changes what goes on the wire. Then the case repeats
+ * until it has run for at least BENCH_MIN_NSECS.
+ *
+ * Results go to stdout as JSON, so two runs can be compared with any JSON tool.
+ * Logs (e.g. unavailable hash providers) go to stderr.
+ *
+ * The RJv3 TLV code is benchmarked with a corpus of frames, see tlv_bench.c.
+ * The DNS cache has its own check, see dns_bench.c.
+ * Batched frame I/O is compared with one syscall per frame in sock_bench.c.
+ * The Whirlpool block function is compared with the unoptimized one in whirlpool_bench.c.
+ *
+ * Usage: minieap_bench [--regen] [filter [corpus dir]]
+ *   Only run cases whose name contains `filter`. "" runs everything.
+ *   Frames are read from bench/corpus by default.
+ *   --regen writes the expected outputs of the frames instead of checking them.
+ * Exit status is non-zero if any golden check fails.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+#include "logging.h"
+#include "misc.h"
+#include "md5.h"
+#include "hash_provider.h"
+#include "checkV4.h"
+#include "rjwhirlpool.h"
+#include "rjcrc16.h"
+#include "rjencode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define BENCH_MAX_LEN 1024
+#define BENCH_MAX_OUT_LEN 128
+
+typedef struct _bench_case {
+    const char* name;
+    int len; /* Input length, also used for throughput */
+    int seed; /* Input is fill_pattern(len, seed) */
+    int out_len;
+    int text_output; /* Output is already hex text, compare as is */
+    /*
+     * One operation. In-place ones may modify `in` and return it,
+     * others write to `out` and return it.
+     */
+    uint8_t* (*op)(uint8_t* in, int len, uint8_t* out);
+    /* Choose this hash provider first. NULL = builtin */
+    const char* hash_provider;
+    const char* golden; /* Expected output in hex */
+} BENCH_CASE;
+
+static volatile uint8_t g_sink;
+
+static void fill_pattern(uint8_t* buf, int len, int seed) {
+    int i;
+    for (i = 0; i < len; ++i) {
+        buf[i] = (uint8_t)(i * 0x9d + seed);
+    }
+}
+
+/*
+ * The operations
+ */
+static uint8_t* op_computeV4(uint8_t* in, int len, uint8_t* out) {
+    return computeV4_r(in, len, out);
+}
+
+static uint8_t* op_computePwd(uint8_t* in, int len, uint8_t* out) {
+    return (uint8_t*)computePwd_r(in, "2018123456", "password123", (char*)out);
+}
+
+static uint8_t* op_ComputeHash(uint8_t* in, int len, uint8_t* out) {
+    return ComputeHash(in, len);
+}
+
+static uint8_t* op_whirlpool(uint8_t* in, int len, uint8_t* out) {
+    whirlpool_ctx _ctx;
+    rhash_whirlpool_init(&_ctx);
+    rhash_whirlpool_update(&_ctx, in, len);
+    rhash_whirlpool_final(&_ctx, out);
+    return out;
+}
+
+static uint8_t* op_crc16(uint8_t* in, int len, uint8_t* out) {
+    uint16_t _crc = crc16(in, len);
+    out[0] = _crc >> 8;
+    out[1] = _crc & 0xff;
+    return out;
+}
+
+static uint8_t* op_rj_encode(uint8_t* in, int len, uint8_t* out) {
+    rj_encode(in, len);
+    return in;
+}
+
+static uint8_t* op_rj_decode(uint8_t* in, int len, uint8_t* out) {
+    rj_decode(in, len);
+    return in;
+}
+
+static uint8_t* op_bit_reverse(uint8_t* in, int len, uint8_t* out) {
+    int i;
+    for (i = 0; i < len; ++i) {
+        in[i] = bit_reverse(in[i]);
+    }
+    return in;
+}
+
+/*
+ * Golden vectors are generated with the same fill_pattern() input
+ * on the code before any optimization.
+ */
+static BENCH_CASE g_cases[] = {
+    /* Seeds are chosen to hit every v4_check_type branch */
+    {"computeV4/type0", 16, 0, 128, TRUE, op_computeV4, NULL,
+        "85ca447612b0a4f8f917586f1f18f13cb0a48a3cbccf0bfa2bbe6542871869b2"
+        "f0a474027b58968dca12ee9c494c60c9e54d3360ab0a63caf2319365988017a8"},
+    {"computeV4/type1", 16, 3, 128, TRUE, op_computeV4, NULL,
+        "b21d26cecdf2cc03711eabb79657a63f13f902dc32c0deac0e591a62a9fd8676"
+        "748714182dfda94f665dcb492304920a0166b0fa82e74419a84ef804f3eac3aa"},
+    {"computeV4/type2", 16, 1, 128, TRUE, op_computeV4, NULL,
+        "e227f8a9d11c69584bc57c5d8968297a50d646354bbb91bf955a4b4a08aa67dd"
+        "6e9b5b82d8ca5bcc006f28609896ef72eda384c9ab9a7f7247d513fafe527ecf"},
+    {"computeV4/type3", 16, 4, 128, TRUE, op_computeV4, NULL,
+        "8b8d5caa217dbc3d7e9492019f044d4b6968e8177c150c3342bffdde8e0a6cf6"
+        "c845d590d89db7e6f53e86d8eba5431696ea2f1a5834b5e07d58cf7440a43720"},
+    {"computeV4/type4", 16, 2, 128, TRUE, op_computeV4, NULL,
+        "2f1ff79f75f8e46979b74238a074bdfc846d7c8adb36d56ef8ce5fbce41722a0"
+        "4774b370894f52be139c54fe245d6afb5cd92ce50b2c82d18b7ff68117cede6b"},
+    {"computePwd/builtin", 16, 1, 16, FALSE, op_computePwd, "builtin",
+        "6426138ad81a3f55ec6e7122970ab9d5"},
+#ifdef __linux__
+    {"computePwd/af_alg", 16, 1, 16, FALSE, op_computePwd, "af_alg",
+        "6426138ad81a3f55ec6e7122970ab9d5"},
+#endif
+#ifdef ENABLE_OPENSSL
+    {"computePwd/openssl", 16, 1, 16, FALSE, op_computePwd, "openssl",
+        "6426138ad81a3f55ec6e7122970ab9d5"},
+#endif
+    {"ComputeHash/64", 64, 7, 16, FALSE, op_ComputeHash, NULL,
+        "af9768ab6f86e84fbb09138c6b6af063"},
+    {"ComputeHash/1024", 1024, 2, 16, FALSE, op_ComputeHash, NULL,
+        "e0233df0d1abfc496ed997b8889f4fb4"},
+    /* The longest V4 hash input is 60 bytes, so this is the size that matters */
+    {"whirlpool/56", 56, 3, 64, FALSE, op_whirlpool, NULL,
+        "f90bfede0011b7703b22f5a9cb1bcf20dedd72c343c4f4004d1b62fbc2cf8a1b"
+        "3e33064f994b52b4cde4698871c8d2340717e36576fabaafee640bf9e7dc8d48"},
+    {"whirlpool/1024", 1024, 3, 64, FALSE, op_whirlpool, NULL,
+        "402e90ef4a741521d33476c88979cebf424d1b46f79b368e79a23464fc17a5bd"
+        "271a0494629062e1974e0f8138ef41b800ab429dc8a0cb12b2166cfb79bf2780"},
+    {"crc16/1024", 1024, 4, 2, FALSE, op_crc16, NULL, "6afc"},
+    {"rj_encode/64", 64, 5, 64, FALSE, op_rj_encode, NULL,
+        "5fba03c4619732f548ae1bdc798026e354b10fca6d983efb42a510d6738c29ef"
+        "5abd04c1679235f04eab1cd97f8623e451b70acd689e3bfc45a016d374892fea"},
+    {"rj_decode/64", 64, 6, 64, FALSE, op_rj_decode, NULL,
+        "9f3afd44a117d275882eeb5cb900c6639431f74aad18de7b8225e056b30cc96f"
+        "9a3df841a712d5708e2bec59bf06c3649137f24da81edb7c8520e653b409cf6a"},
+    {"bit_reverse/64", 64, 8, 64, FALSE, op_bit_reverse, NULL,
+        "10a542fb3e986dca0fb154e3268079dc1bae48f5329761c403ba5fe92c8b76d0"
+        "15a247fe389d6acf09b453e620857cdb1ea84df2379164c306bf59ec2b8e70d5"},
+};
+
+#define CASE_COUNT (sizeof(g_cases) / sizeof(BENCH_CASE))
+
+static const char* check_golden(BENCH_CASE* bench) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    uint8_t _in[BENCH_MAX_LEN];
+    uint8_t _out[BENCH_MAX_OUT_LEN];
+    char _hex[BENCH_MAX_OUT_LEN * 2 + 1];
+    uint8_t* _result;
+    int i;
+
+    fill_pattern(_in, bench->len, bench->seed);
+    _result = bench->op(_in, bench->len, _out);
+    if (bench->text_output) {
+        memcpy(_hex, _result, bench->out_len);
+        _hex[bench->out_len] = 0;
+    } else {
+        for (i = 0; i < bench->out_len; ++i) {
+            _hex[2 * i] = HEX_DIGITS[_result[i] >> 4];
+            _hex[2 * i + 1] = HEX_DIGITS[_result[i] & 0xf];
+        }
+        _hex[2 * i] = 0;
+    }
+
+    if (strcmp(_hex, bench->golden) != 0) {
+        PR_ERR("%s 输出与预期不符\n  预期: %s\n  实际: %s", bench->name, bench->golden, _hex);
+        return "mismatch";
+    }
+    return "ok";
+}
+
+typedef struct _case_run {
+    BENCH_CASE* bench;
+    uint8_t in[BENCH_MAX_LEN];
+    uint8_t out[BENCH_MAX_OUT_LEN];
+} CASE_RUN;
+
+static void run_op(void* ctx) {
+    CASE_RUN* _run = ctx;
+    g_sink = _run->bench->op(_run->in, _run->bench->len, _run->out)[0];
+}
+
+static void run_case(BENCH_CASE* bench, BENCH_RESULT* result) {
+    CASE_RUN _run;
+
+    _run.bench = bench;
+    fill_pattern(_run.in, bench->len, bench->seed);
+    bench_run(run_op, &_run, result);
+}
+
+int main(int argc, char* argv[]) {
+    const char* _filter = NULL;
+    const char* _corpus_dir = DEFAULT_CORPUS_DIR;
+    const char* _golden;
+    const char* _sep = "";
+    BENCH_RESULT _result;
+    int _failures = 0, _regen = FALSE;
+    int i;
+
+    if (argc > 1 && strcmp(argv[1], "--regen") == 0) {
+        _regen = TRUE;
+        argc--;
+        argv++;
+    }
+    if (argc > 1 && argv[1][0]) {
+        _filter = argv[1];
+    }
+    if (argc > 2) {
+        _corpus_dir = argv[2];
+    }
+
+    /* Keep stdout clean for JSON */
+    set_log_file_path("/dev/stderr");
+    set_log_destination(LOG_TO_FILE);
+    start_log();
+
+    printf("{\n  \"benchmarks\": [");
+    for (i = 0; i < CASE_COUNT; ++i) {
+        BENCH_CASE* _case = &g_cases[i];
+
+        if (_filter && strstr(_case->name, _filter) == NULL) {
+            continue;
+        }
+
+        if (IS_FAIL(hash_provider_init(_case->hash_provider ? _case->hash_provider : "builtin"))) {
+            bench_print_result(&_sep, _case->name, NULL, "skipped", "\"bytes\": %d", _case->len);
+            continue;
+        }
+
+        _golden = check_golden(_case);
+        if (strcmp(_golden, "ok") != 0) {
+            _failures++;
+        }
+
+        run_case(_case, &_result);
+        bench_print_result(&_sep, _case->name, &_result, _golden, "\"bytes\": %d, \"mb_per_s\": %.1f",
+                           _case->len, _case->len * 1000.0 / _result.ns_per_op);
+    }
+    _failures += run_whirlpool_benchmarks(_filter, &_sep);
+    _failures += run_tlv_benchmarks(_filter, _corpus_dir, _regen, &_sep);
+    _failures += run_dns_benchmarks(_filter, &_sep);
+    _failures += run_sock_benchmarks(_filter, &_sep);
+    printf("\n  ],\n  \"golden_failures\": %d\n}\n", _failures);
+
+    hash_provider_destroy();
+    close_log();
+    return _failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
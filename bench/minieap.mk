@@ -0,0 +1,50 @@
+# Makefile for microbenchmarks of the RJv3 hashes, codecs and TLV code
+# Not a part of minieap. Run with `make bench`
+
+LOCAL_PATH := $(call my-dir)
+
+LOCAL_SRC_FILES := $(call all-c-files-under,)
+LOCAL_C_INCLUDES := ../packet_plugin/rjv3 ../packet_plugin/rjv3/rjv3_hashes
+LOCAL_CFLAGS :=
+LOCAL_LDFLAGS :=
+LOCAL_MODULE := hash_bench
+
+# Count allocations per frame with GNU ld
+ifeq ($(shell uname -s),Linux)
+LOCAL_CFLAGS += -DBENCH_WRAP_ALLOC
+BENCH_LDFLAGS := -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=strdup
+endif
+
+include $(APPEND)
+
+# Not in BUILD_MODULES, so APPEND does not include our deps
+ifneq ($(filter bench minieap_bench,$(MAKECMDGOALS)),)
+-include $(hash_bench_PRIV_DEPS)
+endif
+
+# The whole RJv3 plugin with what it depends on,
+# but no main() nor network interfaces other than the fake one in tlv_bench.c
+BENCH_OBJS = \
+    $(hash_bench_PRIV_OBJS) \
+    $(packet_plugin_rjv3_PRIV_OBJS) \
+    $(filter-out %/minieap.o,$(main_PRIV_OBJS)) \
+    $(util_PRIV_OBJS) \
+    $(if_impl_manager_PRIV_OBJS) \
+    $(packet_plugin_manager_PRIV_OBJS)
+
+minieap_bench: hash_bench packet_plugin_rjv3 main util if_impl_manager packet_plugin_manager
+	$(CC) -o minieap_bench \
+        $(COMMON_LDFLAGS) \
+        $(BENCH_LDFLAGS) \
+        $(BENCH_OBJS) \
+        $(LIBS)
+
+.PHONY: bench
+bench: minieap_bench
+	./minieap_bench
+
+.PHONY: bench_clean
+bench_clean:
+	rm -f minieap_bench
+
+clean: bench_clean
@@ -0,0 +1,185 @@
+/*
+ * Frame I/O as sockraw does it without the PACKET_MMAP rings
+ *
+ *   sock/plain   One send() per frame, then one recv() into a zeroed
+ *                buffer per frame, as before recvmmsg/sendmmsg were used.
+ *   sock/mmsg    The same frames with one sendmmsg() and one recvmmsg()
+ *                into preallocated buffers.
+ *
+ * One operation is a batch of SOCK_BENCH_BATCH frames of EAP sizes, through
+ * an AF_UNIX datagram socketpair, so no privilege nor interface is needed.
+ * This measures the syscalls saved by batching, not the AF_PACKET path.
+ * Every frame received must match what was sent.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+#include "logging.h"
+#include "if_impl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/socket.h>
+
+#define SOCK_BENCH_BATCH 8 /* MMSG_BATCH in sockraw */
+
+typedef struct _sock_bench {
+    int fds[2];
+    int lens[SOCK_BENCH_BATCH];
+    uint8_t frames[SOCK_BENCH_BATCH][FRAME_BUF_SIZE];
+    uint8_t bufs[SOCK_BENCH_BATCH][FRAME_BUF_SIZE];
+    struct mmsghdr send_msgs[SOCK_BENCH_BATCH];
+    struct iovec send_iovs[SOCK_BENCH_BATCH];
+    struct mmsghdr recv_msgs[SOCK_BENCH_BATCH];
+    struct iovec recv_iovs[SOCK_BENCH_BATCH];
+} SOCK_BENCH;
+
+/*
+ * Send and receive one batch.
+ * Return: number of frames received, or -1 on error
+ */
+typedef int (*SOCK_BENCH_OP)(SOCK_BENCH* bench);
+
+/* Too large for stack */
+static SOCK_BENCH g_bench;
+
+static int op_plain(SOCK_BENCH* bench) {
+    int i, _ret;
+
+    for (i = 0; i < SOCK_BENCH_BATCH; ++i) {
+        if (send(bench->fds[0], bench->frames[i], bench->lens[i], 0) < 0) {
+            PR_ERRNO("send 调用失败");
+            return -1;
+        }
+    }
+    for (i = 0; i < SOCK_BENCH_BATCH; ++i) {
+        memset(bench->bufs[i], 0, FRAME_BUF_SIZE);
+        _ret = recv(bench->fds[1], bench->bufs[i], FRAME_BUF_SIZE, MSG_DONTWAIT);
+        if (_ret < 0) {
+            PR_ERRNO("recv 调用失败");
+            return -1;
+        }
+        bench->recv_msgs[i].msg_len = _ret;
+    }
+    return SOCK_BENCH_BATCH;
+}
+
+static int op_mmsg(SOCK_BENCH* bench) {
+    int _ret;
+
+    if (sendmmsg(bench->fds[0], bench->send_msgs, SOCK_BENCH_BATCH, 0) != SOCK_BENCH_BATCH) {
+        PR_ERRNO("sendmmsg 调用失败");
+        return -1;
+    }
+    _ret = recvmmsg(bench->fds[1], bench->recv_msgs, SOCK_BENCH_BATCH, MSG_DONTWAIT, NULL);
+    if (_ret < 0) {
+        PR_ERRNO("recvmmsg 调用失败");
+    }
+    return _ret;
+}
+
+static RESULT setup_bench(SOCK_BENCH* bench) {
+    int i, j;
+
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, bench->fds) < 0) {
+        PR_ERRNO("无法创建 socketpair");
+        return FAILURE;
+    }
+
+    for (i = 0; i < SOCK_BENCH_BATCH; ++i) {
+        /* From an EAPOL-Start to an RJv3 response with all its props */
+        bench->lens[i] = 60 + i * 80;
+        for (j = 0; j < bench->lens[i]; ++j) {
+            bench->frames[i][j] = (uint8_t)(i * 31 + j * 7);
+        }
+
+        bench->send_iovs[i].iov_base = bench->frames[i];
+        bench->send_iovs[i].iov_len = bench->lens[i];
+        bench->send_msgs[i].msg_hdr.msg_iov = &bench->send_iovs[i];
+        bench->send_msgs[i].msg_hdr.msg_iovlen = 1;
+
+        bench->recv_iovs[i].iov_base = bench->bufs[i];
+        bench->recv_iovs[i].iov_len = FRAME_BUF_SIZE;
+        bench->recv_msgs[i].msg_hdr.msg_iov = &bench->recv_iovs[i];
+        bench->recv_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    return SUCCESS;
+}
+
+static const char* check_golden(SOCK_BENCH* bench, SOCK_BENCH_OP op) {
+    int i;
+
+    memset(bench->bufs, 0, sizeof(bench->bufs));
+    if (op(bench) != SOCK_BENCH_BATCH) {
+        return "error";
+    }
+    for (i = 0; i < SOCK_BENCH_BATCH; ++i) {
+        if (bench->recv_msgs[i].msg_len != bench->lens[i]
+                || memcmp(bench->bufs[i], bench->frames[i], bench->lens[i]) != 0) {
+            return "mismatch";
+        }
+    }
+    return "ok";
+}
+
+typedef struct _op_run {
+    SOCK_BENCH_OP op;
+    int failed;
+} OP_RUN;
+
+static void run_op(void* ctx) {
+    OP_RUN* _run = ctx;
+    if (_run->op(&g_bench) != SOCK_BENCH_BATCH) {
+        _run->failed = TRUE;
+    }
+}
+
+static int run_case(const char* name, SOCK_BENCH_OP op, const char** sep) {
+    OP_RUN _run = {op, FALSE};
+    BENCH_RESULT _result;
+    const char* _golden;
+
+    _golden = check_golden(&g_bench, op);
+    if (strcmp(_golden, "ok") != 0) {
+        bench_print_result(sep, name, NULL, _golden, NULL);
+        return 1;
+    }
+
+    bench_run(run_op, &_run, &_result);
+    if (_run.failed) {
+        _golden = "error";
+    }
+    bench_print_result(sep, name, &_result, _golden, "\"frames\": %d, \"ns_per_frame\": %.1f",
+                       SOCK_BENCH_BATCH, _result.ns_per_op / SOCK_BENCH_BATCH);
+    return strcmp(_golden, "ok") != 0;
+}
+
+int run_sock_benchmarks(const char* filter, const char** sep) {
+    int _failures = 0;
+
+    if (filter != NULL && strstr("sock/plain", filter) == NULL && strstr("sock/mmsg", filter) == NULL) {
+        return 0;
+    }
+
+    if (IS_FAIL(setup_bench(&g_bench))) {
+        return 1;
+    }
+    if (filter == NULL || strstr("sock/plain", filter) != NULL) {
+        _failures += run_case("sock/plain", op_plain, sep);
+    }
+    if (filter == NULL || strstr("sock/mmsg", filter) != NULL) {
+        _failures += run_case("sock/mmsg", op_mmsg, sep);
+    }
+    close(g_bench.fds[0]);
+    close(g_bench.fds[1]);
+    return _failures;
+}
+#else
+int run_sock_benchmarks(const char* filter, const char** sep) {
+    return 0;
+}
+#endif
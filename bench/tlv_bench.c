@@ -0,0 +1,532 @@
+/*
+ * Replay a corpus of frames through the RJv3 TLV (prop) code
+ *
+ * Every `<name>.in` in the corpus directory is a frame in hex, whitespace is
+ * ignored and `#` starts a comment. What happens to it depends on the frame:
+ *
+ *   EAPOL-Start      rjv3_append_priv() on the frame itself.
+ *                    Expected output is the whole frame after that.
+ *   EAP-Request      Received by the plugin, then rjv3_append_priv() on a
+ *                    response with header only. Expected output is the response.
+ *   EAP-Success      rjv3_props_parse() and rjv3_process_result_prop().
+ *   EAP-Failure      Expected output is the parsed props serialized again,
+ *                    followed by the echo key (Success only, 4 bytes).
+ *
+ * Expected output is `<name>.out` in the same format. A missing one is a
+ * failure. With `regen`, all of them are (re)written from the current output
+ * instead, so new frames can be dropped in. Check the diff before committing.
+ *
+ * Each `.in` says where it comes from in a "Provenance:" comment.
+ *
+ * The environment is fixed (interface "lo", fake serial and DNS), so that
+ * the output does not depend on the machine. The interface and DNS caches are
+ * used as minieap does, so address lookups are not repeated for every frame.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+#include "logging.h"
+#include "misc.h"
+#include "config.h"
+#include "eth_frame.h"
+#include "if_impl.h"
+#include "net_util.h"
+#include "packet_plugin.h"
+#include "packet_plugin_rjv3.h"
+#include "packet_plugin_rjv3_priv.h"
+#include "packet_plugin_rjv3_prop.h"
+#include "packet_plugin_rjv3_keepalive.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <net/if.h>
+
+#define CORPUS_MAX_FILES 64
+#define CORPUS_PATH_LEN 512
+#define CORPUS_NAME_LEN 64
+#define CORPUS_IN_SUFFIX ".in"
+#define CORPUS_OUT_SUFFIX ".out"
+
+#define BENCH_IFNAME "lo"
+#define BENCH_USERNAME "2018123456"
+#define BENCH_PASSWORD "password123"
+
+typedef enum _corpus_kind {
+    CORPUS_START,
+    CORPUS_REQUEST,
+    CORPUS_RESULT
+} CORPUS_KIND;
+
+typedef struct _corpus_frame {
+    char name[CORPUS_NAME_LEN];
+    CORPUS_KIND kind;
+    int len;
+    uint8_t buf[FRAME_BUF_SIZE];
+} CORPUS_FRAME;
+
+/*
+ * One operation on a frame. Writes what is to be compared to `out`,
+ * returns its length, or -1 on error.
+ */
+typedef int (*CORPUS_OP)(CORPUS_FRAME* frame, uint8_t* out);
+
+static PACKET_PLUGIN* g_rjv3;
+static char g_ifname[IFNAMSIZ];
+
+#define PRIV ((rjv3_priv*)(g_rjv3->priv))
+
+/*
+ * A network interface that only has a name,
+ * which is all the RJv3 plugin asks for when building frames
+ */
+static RESULT bench_if_set_ifname(IF_IMPL* this, const char* ifname) {
+    strncpy(g_ifname, ifname, IFNAMSIZ - 1);
+    return SUCCESS;
+}
+
+static RESULT bench_if_get_ifname(IF_IMPL* this, char* buf, int buflen) {
+    strncpy(buf, g_ifname, buflen);
+    return SUCCESS;
+}
+
+static void bench_if_destroy(IF_IMPL* this) {
+}
+
+static IF_IMPL* bench_if_impl_new() {
+    static IF_IMPL _impl = {
+        .set_ifname = bench_if_set_ifname,
+        .get_ifname = bench_if_get_ifname,
+        .destroy = bench_if_destroy,
+        .name = "bench",
+        .description = "Benchmark only",
+    };
+    return &_impl;
+}
+IF_IMPL_INIT(bench_if_impl_new)
+
+/* Logs of the code under test should not flood the console */
+static void log_to(char* path) {
+    close_log();
+    set_log_file_path(path);
+    start_log();
+}
+
+/*
+ * Corpus files
+ */
+static int read_hex_file(const char* path, uint8_t* buf, int buflen) {
+    FILE* _fp = fopen(path, "r");
+    char _digits[3] = {0};
+    int _c, _ndigits = 0, _len = 0;
+
+    if (_fp == NULL) {
+        return -1;
+    }
+
+    while ((_c = fgetc(_fp)) != EOF) {
+        if (_c == '#') {
+            while ((_c = fgetc(_fp)) != EOF && _c != '\n');
+        } else if (isxdigit(_c)) {
+            _digits[_ndigits++] = _c;
+            if (_ndigits == 2) {
+                if (_len >= buflen) {
+                    PR_ERR("%s 过长", path);
+                    fclose(_fp);
+                    return -1;
+                }
+                buf[_len++] = char2hex(_digits);
+                _ndigits = 0;
+            }
+        } else if (!isspace(_c)) {
+            PR_ERR("%s 含有非十六进制字符 '%c'", path, _c);
+            fclose(_fp);
+            return -1;
+        }
+    }
+
+    fclose(_fp);
+    return _ndigits == 0 ? _len : -1;
+}
+
+static RESULT write_hex_file(const char* path, const uint8_t* buf, int len) {
+    FILE* _fp = fopen(path, "w");
+    char _hex[2];
+    int i;
+
+    if (_fp == NULL) {
+        PR_ERRNO("无法写入预期结果文件");
+        return FAILURE;
+    }
+
+    for (i = 0; i < len; ++i) {
+        hex2char(buf[i], _hex);
+        fprintf(_fp, "%c%c%c", _hex[0], _hex[1], (i % 16 == 15 || i == len - 1) ? '\n' : ' ');
+    }
+
+    fclose(_fp);
+    return SUCCESS;
+}
+
+static int name_cmp(const void* a, const void* b) {
+    return strcmp(((const CORPUS_FRAME*)a)->name, ((const CORPUS_FRAME*)b)->name);
+}
+
+static RESULT classify_frame(CORPUS_FRAME* frame) {
+    FRAME_HEADER* _hdr = (FRAME_HEADER*)frame->buf;
+
+    if (frame->len < sizeof(ETHERNET_HEADER) + sizeof(EAPOL_HEADER)) {
+        return FAILURE;
+    }
+
+    if (_hdr->eapol_hdr.type[0] == EAPOL_START) {
+        frame->kind = CORPUS_START;
+        return SUCCESS;
+    }
+
+    if (_hdr->eapol_hdr.type[0] != EAP_PACKET
+            || frame->len < sizeof(FRAME_HEADER) - sizeof(_hdr->eap_hdr.type)) {
+        return FAILURE;
+    }
+
+    switch (_hdr->eap_hdr.code[0]) {
+        case EAP_REQUEST:
+            frame->kind = CORPUS_REQUEST;
+            return frame->len < sizeof(FRAME_HEADER) ? FAILURE : SUCCESS;
+        case EAP_SUCCESS:
+        case EAP_FAILURE:
+            frame->kind = CORPUS_RESULT;
+            return SUCCESS;
+        default:
+            return FAILURE;
+    }
+}
+
+/*
+ * Load all frames in `dir`, sorted by name. Returns how many are loaded
+ */
+static int load_corpus(const char* dir, CORPUS_FRAME* frames, int max) {
+    char _path[CORPUS_PATH_LEN];
+    struct dirent* _ent;
+    DIR* _dir = opendir(dir);
+    size_t _namelen;
+    int _count = 0;
+
+    if (_dir == NULL) {
+        PR_ERRNO("无法打开样本目录");
+        return 0;
+    }
+
+    while ((_ent = readdir(_dir)) != NULL && _count < max) {
+        CORPUS_FRAME* _frame = &frames[_count];
+
+        _namelen = strlen(_ent->d_name);
+        if (_namelen <= strlen(CORPUS_IN_SUFFIX)
+                || _namelen - strlen(CORPUS_IN_SUFFIX) >= CORPUS_NAME_LEN
+                || strcmp(_ent->d_name + _namelen - strlen(CORPUS_IN_SUFFIX), CORPUS_IN_SUFFIX) != 0) {
+            continue;
+        }
+
+        memset(_frame->name, 0, CORPUS_NAME_LEN);
+        memmove(_frame->name, _ent->d_name, _namelen - strlen(CORPUS_IN_SUFFIX));
+        snprintf(_path, CORPUS_PATH_LEN, "%s/%s", dir, _ent->d_name);
+        _frame->len = read_hex_file(_path, _frame->buf, FRAME_BUF_SIZE);
+        if (_frame->len < 0 || IS_FAIL(classify_frame(_frame))) {
+            PR_WARN("%s 不是可用的样本，已跳过", _path);
+            continue;
+        }
+        _count++;
+    }
+
+    closedir(_dir);
+    qsort(frames, _count, sizeof(CORPUS_FRAME), name_cmp);
+    return _count;
+}
+
+/*
+ * The operations
+ */
+static int op_start(CORPUS_FRAME* frame, uint8_t* out) {
+    ETH_EAP_FRAME _frame = {
+        .actual_len = frame->len,
+        .buffer_len = FRAME_BUF_SIZE,
+        .content = out
+    };
+
+    PRIV->last_recv_md5 = FALSE;
+    memmove(out, frame->buf, frame->len);
+    if (IS_FAIL(g_rjv3->prepare_frame(g_rjv3, &_frame))) {
+        return -1;
+    }
+    return _frame.actual_len;
+}
+
+static int op_request(CORPUS_FRAME* frame, uint8_t* out) {
+    ETH_EAP_FRAME _request = {
+        .actual_len = frame->len,
+        .buffer_len = FRAME_BUF_SIZE,
+        .content = frame->buf
+    };
+    ETH_EAP_FRAME _response = {
+        .actual_len = sizeof(FRAME_HEADER),
+        .buffer_len = FRAME_BUF_SIZE,
+        .content = out
+    };
+    FRAME_HEADER* _req_hdr = _request.header;
+    FRAME_HEADER* _resp_hdr = _response.header;
+
+    /* Only the header, the rest is done by packet_builder in real life */
+    memmove(_resp_hdr->eth_hdr.dest_mac, _req_hdr->eth_hdr.src_mac, sizeof(_req_hdr->eth_hdr.src_mac));
+    memmove(_resp_hdr->eth_hdr.src_mac, _req_hdr->eth_hdr.dest_mac, sizeof(_req_hdr->eth_hdr.dest_mac));
+    memmove(_resp_hdr->eth_hdr.protocol, _req_hdr->eth_hdr.protocol, sizeof(_req_hdr->eth_hdr.protocol));
+    _resp_hdr->eapol_hdr.ver[0] = _req_hdr->eapol_hdr.ver[0];
+    _resp_hdr->eapol_hdr.type[0] = EAP_PACKET;
+    _resp_hdr->eapol_hdr.len[0] = 0;
+    _resp_hdr->eapol_hdr.len[1] = sizeof(EAP_HEADER);
+    _resp_hdr->eap_hdr.code[0] = EAP_RESPONSE;
+    _resp_hdr->eap_hdr.id[0] = _req_hdr->eap_hdr.id[0];
+    _resp_hdr->eap_hdr.len[0] = 0;
+    _resp_hdr->eap_hdr.len[1] = sizeof(EAP_HEADER);
+    _resp_hdr->eap_hdr.type[0] = _req_hdr->eap_hdr.type[0];
+
+    if (IS_FAIL(g_rjv3->on_frame_received(g_rjv3, &_request))
+            || IS_FAIL(g_rjv3->prepare_frame(g_rjv3, &_response))) {
+        return -1;
+    }
+    return _response.actual_len;
+}
+
+/* Where the props start in Success/Failure frames, see rjv3_process_result_prop */
+#define RESULT_PROPS_OFFSET (sizeof(FRAME_HEADER) - sizeof(((FRAME_HEADER*)0)->eap_hdr.type))
+
+static int op_parse(CORPUS_FRAME* frame, uint8_t* out) {
+    RJV3_PROPS _props;
+
+    /* Malformed tail is expected in some frames, keep what is parsed */
+    rjv3_props_parse(&_props, frame->buf + RESULT_PROPS_OFFSET, frame->len - RESULT_PROPS_OFFSET, TRUE);
+    return rjv3_props_to_buffer(&_props, out, FRAME_BUF_SIZE);
+}
+
+static int op_result(CORPUS_FRAME* frame, uint8_t* out) {
+    ETH_EAP_FRAME _frame = {
+        .actual_len = frame->len,
+        .buffer_len = FRAME_BUF_SIZE,
+        .content = frame->buf
+    };
+    uint32_t _echokey;
+
+    rjv3_keepalive_reset();
+    rjv3_process_result_prop(&_frame);
+    if (_frame.header->eap_hdr.code[0] != EAP_SUCCESS) {
+        return 0;
+    }
+
+    _echokey = rjv3_get_keepalive_echokey();
+    out[0] = _echokey >> 24;
+    out[1] = _echokey >> 16;
+    out[2] = _echokey >> 8;
+    out[3] = _echokey;
+    return 4;
+}
+
+/*
+ * What is stored in the .out file
+ */
+static int expected_output(CORPUS_FRAME* frame, uint8_t* out) {
+    int _len, _len2;
+
+    switch (frame->kind) {
+        case CORPUS_START:
+            rjv3_invalidate_templates(g_rjv3);
+            return op_start(frame, out);
+        case CORPUS_REQUEST:
+            rjv3_invalidate_templates(g_rjv3);
+            return op_request(frame, out);
+        case CORPUS_RESULT:
+            if ((_len = op_parse(frame, out)) < 0) {
+                return -1;
+            }
+            log_to("/dev/null");
+            _len2 = op_result(frame, out + _len);
+            log_to("/dev/stderr");
+            return _len2 < 0 ? -1 : _len + _len2;
+    }
+    return -1;
+}
+
+static const char* check_golden(const char* corpus_dir, CORPUS_FRAME* frame, int regen) {
+    uint8_t _out[FRAME_BUF_SIZE];
+    uint8_t _expected[FRAME_BUF_SIZE];
+    uint8_t _again[FRAME_BUF_SIZE];
+    char _path[CORPUS_PATH_LEN];
+    int _len, _expected_len;
+
+    _len = expected_output(frame, _out);
+    if (_len < 0) {
+        PR_ERR("%s 处理失败", frame->name);
+        return "error";
+    }
+
+    /* Frames after the first one are patched from the template, they should be the same */
+    if (frame->kind != CORPUS_RESULT) {
+        if ((frame->kind == CORPUS_START ? op_start : op_request)(frame, _again) != _len
+                || memcmp(_out, _again, _len) != 0) {
+            PR_ERR("%s 第二次处理的输出与第一次不同", frame->name);
+            return "mismatch";
+        }
+    }
+
+    snprintf(_path, CORPUS_PATH_LEN, "%s/%s%s", corpus_dir, frame->name, CORPUS_OUT_SUFFIX);
+    if (regen) {
+        PR_INFO("已根据当前输出写入 %s", _path);
+        return IS_FAIL(write_hex_file(_path, _out, _len)) ? "error" : "regenerated";
+    }
+
+    _expected_len = read_hex_file(_path, _expected, FRAME_BUF_SIZE);
+    if (_expected_len < 0) {
+        PR_ERR("%s 不存在，请使用 --regen 生成", _path);
+        return "missing";
+    }
+
+    if (_expected_len != _len || memcmp(_expected, _out, _len) != 0) {
+        PR_ERR("%s 输出与 %s 不符（预期 %d 字节，实际 %d 字节）", frame->name, _path, _expected_len, _len);
+        return "mismatch";
+    }
+    return "ok";
+}
+
+typedef struct _op_run {
+    CORPUS_OP op;
+    CORPUS_FRAME* frame;
+    uint8_t out[FRAME_BUF_SIZE];
+} OP_RUN;
+
+static void run_op(void* ctx) {
+    OP_RUN* _run = ctx;
+    _run->op(_run->frame, _run->out);
+}
+
+static void print_result(const char** sep, const char* op_name, CORPUS_OP op,
+                         CORPUS_FRAME* frame, const char* golden) {
+    /* Too large for stack */
+    static OP_RUN _run;
+    BENCH_RESULT _result;
+    char _name[CORPUS_NAME_LEN + 16];
+
+    _run.op = op;
+    _run.frame = frame;
+    /* Server messages and parser warnings would be printed on every run */
+    log_to("/dev/null");
+    bench_run(run_op, &_run, &_result);
+    log_to("/dev/stderr");
+
+    snprintf(_name, sizeof(_name), "tlv/%s/%s", op_name, frame->name);
+    bench_print_result(sep, _name, &_result, golden, "\"bytes\": %d, \"frames_per_s\": %.0f",
+                       frame->len, 1e9 / _result.ns_per_op);
+}
+
+/* Does `filter` match the name of any benchmark on this frame */
+static int frame_selected(const char* filter, CORPUS_FRAME* frame) {
+    char _name[CORPUS_NAME_LEN + 16];
+
+    if (filter == NULL) {
+        return TRUE;
+    }
+
+    if (frame->kind == CORPUS_RESULT) {
+        snprintf(_name, sizeof(_name), "tlv/parse/%s", frame->name);
+        if (strstr(_name, filter)) {
+            return TRUE;
+        }
+        snprintf(_name, sizeof(_name), "tlv/result/%s", frame->name);
+    } else {
+        snprintf(_name, sizeof(_name), "tlv/build/%s", frame->name);
+    }
+    return strstr(_name, filter) != NULL;
+}
+
+static RESULT setup_plugin() {
+    static char* _argv[] = {
+        "minieap_bench",
+        "--fake-serial", "BENCH0001",
+        "--fake-dns2", "10.0.0.2",
+        NULL
+    };
+    EAP_CONFIG* _eap_config = get_eap_config();
+
+    _eap_config->username = BENCH_USERNAME;
+    _eap_config->password = BENCH_PASSWORD;
+
+    init_if_impl_list();
+    if (IS_FAIL(select_if_impl("bench"))
+            || IS_FAIL(get_if_impl()->set_ifname(get_if_impl(), BENCH_IFNAME))) {
+        return FAILURE;
+    }
+
+    if ((g_rjv3 = packet_plugin_rjv3_new()) == NULL) {
+        return FAILURE;
+    }
+    g_rjv3->load_default_params(g_rjv3);
+
+#ifdef __linux__
+    /* Lookups work without them, just slower */
+    iface_cache_init(BENCH_IFNAME);
+    dns_cache_init(RESOLV_CONF_PATH);
+#endif
+    return g_rjv3->process_cmdline_opts(g_rjv3, sizeof(_argv) / sizeof(char*) - 1, _argv);
+}
+
+static void destroy_plugin() {
+    EAP_CONFIG* _eap_config = get_eap_config();
+
+    if (g_rjv3 != NULL) {
+        g_rjv3->destroy(g_rjv3);
+        g_rjv3 = NULL;
+    }
+    free_if_impl();
+#ifdef __linux__
+    iface_cache_destroy();
+    dns_cache_destroy();
+#endif
+    _eap_config->username = NULL;
+    _eap_config->password = NULL;
+}
+
+int run_tlv_benchmarks(const char* filter, const char* corpus_dir, int regen, const char** sep) {
+    /* Too large for stack */
+    static CORPUS_FRAME _frames[CORPUS_MAX_FILES];
+    const char* _golden;
+    int _count, _failures = 0, i;
+
+    if (IS_FAIL(setup_plugin())) {
+        PR_ERR("RJv3 插件初始化失败");
+        destroy_plugin();
+        return 1;
+    }
+
+    _count = load_corpus(corpus_dir, _frames, CORPUS_MAX_FILES);
+    for (i = 0; i < _count; ++i) {
+        CORPUS_FRAME* _frame = &_frames[i];
+
+        if (!frame_selected(filter, _frame)) {
+            continue;
+        }
+
+        _golden = check_golden(corpus_dir, _frame, regen);
+        if (strcmp(_golden, "ok") != 0 && strcmp(_golden, "regenerated") != 0) {
+            _failures++;
+        }
+
+        if (_frame->kind == CORPUS_RESULT) {
+            print_result(sep, "parse", op_parse, _frame, _golden);
+            print_result(sep, "result", op_result, _frame, _golden);
+        } else {
+            print_result(sep, "build", _frame->kind == CORPUS_START ? op_start : op_request, _frame, _golden);
+        }
+    }
+
+    destroy_plugin();
+    return _failures;
+}
@@ -0,0 +1,212 @@
+/*
+ * The RJ Whirlpool block function against the one before it was optimized
+ *
+ *   whirlpool_cmp/before/<n>   The old rhash_whirlpool_process_block(), kept
+ *                              here as the reference, with the old update/final
+ *   whirlpool_cmp/after/<n>    rhash_whirlpool_*() as used by computeV4
+ *
+ * Both hash the same n-byte message, and their digests must match.
+ * Cost is reported per byte of message, in TSC cycles where rdtsc is
+ * available (which ticks at a fixed rate, not the core clock), and in ns.
+ */
+#include "minieap_common.h"
+#include "bench.h"
+#include "logging.h"
+#include "byte_order.h"
+#include "rjwhirlpool.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define WHIRLPOOL_BENCH_MAX_LEN 1024
+
+/* Algorithm S-Box, shared with the current code */
+extern const uint64_t rhash_whirlpool_sbox[8][256];
+
+#define REF_WHIRLPOOL_OP(src, shift) ( \
+    rhash_whirlpool_sbox[0][(int)(src[ shift      & 7] >> 56)       ] ^ \
+    rhash_whirlpool_sbox[1][(int)(src[(shift + 7) & 7] >> 48) & 0xff] ^ \
+    rhash_whirlpool_sbox[2][(int)(src[(shift + 6) & 7] >> 40) & 0xff] ^ \
+    rhash_whirlpool_sbox[3][(int)(src[(shift + 5) & 7] >> 32) & 0xff] ^ \
+    rhash_whirlpool_sbox[4][(int)(src[(shift + 4) & 7] >> 24) & 0xff] ^ \
+    rhash_whirlpool_sbox[5][(int)(src[(shift + 3) & 7] >> 16) & 0xff] ^ \
+    rhash_whirlpool_sbox[6][(int)(src[(shift + 2) & 7] >>  8) & 0xff] ^ \
+    rhash_whirlpool_sbox[7][(int)(src[(shift + 1) & 7]      ) & 0xff])
+
+/*
+ * The block function as it was, apart from names and the removed comments
+ */
+static void ref_whirlpool_process_block(uint64_t *hash, uint64_t* p_block)
+{
+    int i;
+    uint64_t K[2][8];
+    uint64_t state[2][8];
+    unsigned int m = 0;
+    const int number_of_rounds = 10;
+    static const uint64_t rc[10] = {
+        I64(0x1823c6e887b8014f),
+        I64(0x36a6d2f5796f9152),
+        I64(0x60bc9b8ea30c7b35),
+        I64(0x1de0d7c22e4bfe57),
+        I64(0x157737e59ff04ada),
+        I64(0x58c9290ab1a06b85),
+        I64(0xbd5d10f4cb3e0567),
+        I64(0xe427418ba77d95d8),
+        I64(0xfbee7c66dd17479e),
+        I64(0xca2dbf07ad5a8333)
+    };
+
+    for (i = 0; i < 8; i++) {
+        K[0][i] = hash[i];
+        state[0][i] = be2me_64(p_block[i]) ^ hash[i];
+        hash[i] = state[0][i];
+    }
+
+    for (i = 0; i < number_of_rounds; i++)
+    {
+        K[m ^ 1][0] = REF_WHIRLPOOL_OP(K[m], 0) ^ rc[i];
+        K[m ^ 1][1] = REF_WHIRLPOOL_OP(K[m], 1);
+        K[m ^ 1][2] = REF_WHIRLPOOL_OP(K[m], 2);
+        K[m ^ 1][3] = REF_WHIRLPOOL_OP(K[m], 3);
+        K[m ^ 1][4] = REF_WHIRLPOOL_OP(K[m], 4);
+        K[m ^ 1][5] = REF_WHIRLPOOL_OP(K[m], 5);
+        K[m ^ 1][6] = REF_WHIRLPOOL_OP(K[m], 6);
+        K[m ^ 1][7] = REF_WHIRLPOOL_OP(K[m], 7);
+
+        state[m ^ 1][0] = REF_WHIRLPOOL_OP(state[m], 0) ^ K[m ^ 1][0];
+        state[m ^ 1][1] = (REF_WHIRLPOOL_OP(state[m], 1) ^ K[m ^ 1][1]);
+        state[m ^ 1][2] = (REF_WHIRLPOOL_OP(state[m], 2) ^ K[m ^ 1][2]) + 1;
+        state[m ^ 1][3] = (REF_WHIRLPOOL_OP(state[m], 3) ^ K[m ^ 1][3]);
+        state[m ^ 1][4] = (REF_WHIRLPOOL_OP(state[m], 4) ^ K[m ^ 1][4]);
+        state[m ^ 1][5] = (REF_WHIRLPOOL_OP(state[m], 5) ^ K[m ^ 1][5]) + 1;
+        state[m ^ 1][6] = (REF_WHIRLPOOL_OP(state[m], 6) ^ K[m ^ 1][6]) + 1;
+        state[m ^ 1][7] = (REF_WHIRLPOOL_OP(state[m], 7) ^ K[m ^ 1][7]);
+
+        m = m ^ 1;
+    }
+
+    hash[0] ^= state[0][0];
+    hash[1] ^= state[0][1];
+    hash[2] ^= state[0][2];
+    hash[3] ^= state[0][3];
+    hash[4] ^= state[0][4];
+    hash[5] ^= state[0][5];
+    hash[6] ^= state[0][6];
+    hash[7] ^= state[0][7];
+}
+
+/*
+ * Whole message with the old block function, as init/update/final did
+ * for one update with the whole message
+ */
+static void ref_whirlpool(const uint8_t* msg, size_t size, uint8_t* result) {
+    whirlpool_ctx _ctx;
+    uint64_t* _msg64 = (uint64_t*)_ctx.message;
+    unsigned _index = size & 63;
+
+    rhash_whirlpool_init(&_ctx);
+    _ctx.length = size;
+    while (size >= whirlpool_block_size) {
+        if (IS_ALIGNED_64(msg)) {
+            ref_whirlpool_process_block(_ctx.hash, (uint64_t*)msg);
+        } else {
+            memcpy(_ctx.message, msg, whirlpool_block_size);
+            ref_whirlpool_process_block(_ctx.hash, _msg64);
+        }
+        msg += whirlpool_block_size;
+        size -= whirlpool_block_size;
+    }
+    memcpy(_ctx.message, msg, size);
+
+    _ctx.message[_index++] = 0x80;
+    if (_index > 32) {
+        while (_index < 64) {
+            _ctx.message[_index++] = 0;
+        }
+        ref_whirlpool_process_block(_ctx.hash, _msg64);
+        _index = 0;
+    }
+    while (_index < 56) {
+        _ctx.message[_index++] = 0;
+    }
+    _msg64[7] = be2me_64(_ctx.length << 3);
+    ref_whirlpool_process_block(_ctx.hash, _msg64);
+
+    be64_copy(result, 0, _ctx.hash, 64);
+}
+
+static void cur_whirlpool(const uint8_t* msg, size_t size, uint8_t* result) {
+    whirlpool_ctx _ctx;
+
+    rhash_whirlpool_init(&_ctx);
+    rhash_whirlpool_update(&_ctx, msg, size);
+    rhash_whirlpool_final(&_ctx, result);
+}
+
+typedef struct _whirlpool_run {
+    void (*hash)(const uint8_t* msg, size_t size, uint8_t* result);
+    int len;
+    uint8_t msg[WHIRLPOOL_BENCH_MAX_LEN];
+    uint8_t digest[64];
+} WHIRLPOOL_RUN;
+
+static void run_op(void* ctx) {
+    WHIRLPOOL_RUN* _run = ctx;
+    _run->hash(_run->msg, _run->len, _run->digest);
+}
+
+static void run_case(const char* name, WHIRLPOOL_RUN* run, const char* golden, const char** sep) {
+    BENCH_RESULT _result;
+
+    bench_run(run_op, run, &_result);
+    if (bench_cycles_counted()) {
+        bench_print_result(sep, name, &_result, golden,
+                "\"bytes\": %d, \"cycles_per_byte\": %.1f, \"ns_per_byte\": %.2f", run->len,
+                (double)_result.cycles / _result.iterations / run->len, _result.ns_per_op / run->len);
+    } else {
+        bench_print_result(sep, name, &_result, golden,
+                "\"bytes\": %d, \"cycles_per_byte\": null, \"ns_per_byte\": %.2f", run->len,
+                _result.ns_per_op / run->len);
+    }
+}
+
+int run_whirlpool_benchmarks(const char* filter, const char** sep) {
+    /* computeV4 hashes 52-96 bytes, the longer one shows the bulk rate */
+    static const int LENS[] = {60, 96, 1024};
+    static WHIRLPOOL_RUN _before, _after;
+    uint8_t _digest[64];
+    char _before_name[64], _after_name[64];
+    const char* _golden;
+    int _failures = 0;
+    int i, j;
+
+    for (i = 0; i < sizeof(LENS) / sizeof(int); ++i) {
+        snprintf(_before_name, sizeof(_before_name), "whirlpool_cmp/before/%d", LENS[i]);
+        snprintf(_after_name, sizeof(_after_name), "whirlpool_cmp/after/%d", LENS[i]);
+        /* One without the other compares nothing */
+        if (filter != NULL && strstr(_before_name, filter) == NULL && strstr(_after_name, filter) == NULL) {
+            continue;
+        }
+
+        _before.hash = ref_whirlpool;
+        _after.hash = cur_whirlpool;
+        _before.len = _after.len = LENS[i];
+        for (j = 0; j < LENS[i]; ++j) {
+            _before.msg[j] = _after.msg[j] = (uint8_t)(j * 0x9d + i);
+        }
+
+        ref_whirlpool(_before.msg, LENS[i], _digest);
+        cur_whirlpool(_after.msg, LENS[i], _after.digest);
+        _golden = "ok";
+        if (memcmp(_digest, _after.digest, sizeof(_digest)) != 0) {
+            PR_ERR("%d 字节消息的 Whirlpool 结果与优化前不符", LENS[i]);
+            _golden = "mismatch";
+            _failures++;
+        }
+
+        run_case(_before_name, &_before, _golden, sep);
+        run_case(_after_name, &_after, _golden, sep);
+    }
+    return _failures;
+}
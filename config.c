@@ -5,6 +5,7 @@
 #include <getopt.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <net/if.h>
 
 #include "config.h"
@@ -46,7 +47,10 @@ void load_default_params() {
     PCFG.daemon_type = DEFAULT_DAEMON_TYPE;
     PCFG.max_retries = DEFAULT_MAX_RETRIES;
     PCFG.max_failures = DEFAULT_MAX_FAILURES;
-    PCFG.stage_timeout = DEFAULT_STAGE_TIMEOUT;
+    PCFG.stage_timeout_ms = DEFAULT_STAGE_TIMEOUT * 1000;
+    PCFG.start_policy.timeout_ms = PCFG.start_policy.max_retries = STATE_POLICY_DEFAULT;
+    PCFG.identity_policy.timeout_ms = PCFG.identity_policy.max_retries = STATE_POLICY_DEFAULT;
+    PCFG.challenge_policy.timeout_ms = PCFG.challenge_policy.max_retries = STATE_POLICY_DEFAULT;
     PCFG.save_now = DEFAULT_SAVE_NOW;
     PCFG.auth_round = DEFAULT_AUTH_ROUND;
     PCFG.kill_type = DEFAULT_KILL_TYPE;
@@ -91,7 +95,7 @@ static void print_cmdline_help() {
         "\t--username, -u <...>\t用户名\n"
         "\t--password, -p <...>\t密码\n"
         "\t--nic, -n <...>\t\t要使用的网络界面名\n"
-        "\t--stage-timeout, -t <num>\t单个认证阶段的超时时间 [默认" STR(DEFAULT_STAGE_TIMEOUT) "]\n"
+        "\t--stage-timeout, -t <num>\t单个认证阶段的超时时间（秒，可为小数） [默认" STR(DEFAULT_STAGE_TIMEOUT) "]\n"
         "\t--wait-after-fail, -r <num>\t认证失败后重新认证前的等待时间（但当服务器要求重新认证时将直接开始认证）[默认" STR(DEFAULT_WAIT_AFTER_FAIL_SECS) "]\n"
         "\t--max-fail, -l <num>\t最大允许认证失败次数 [默认" STR(DEFAULT_MAX_FAILURES) "]\n"
         "\t--no-auto-reauth, -x\t认证掉线后不允许自动重连 [默认" STR(DEFAULT_RESTART_ON_LOGOFF) "]\n"
@@ -103,9 +107,17 @@ static void print_cmdline_help() {
         "\t--proxy-lan-iface, -z <...>\t代理认证时的 LAN 网络界面名 [默认无]\n"
         "\t--auth-round, -j <num>\t需要认证的次数 [默认1]\n"
         "\t--max-retries <num>\t最大超时重试的次数 [默认3]\n"
+            "\t\t\t\t未指定固定超时时间的阶段会根据服务器响应时间更快地重试，\n"
+            "\t\t\t\t直到等待了 --max-retries 个 --stage-timeout 才放弃\n"
+        "\t--start-timeout <num>\t--start-retries <num>\n"
+        "\t--identity-timeout <num>\t--identity-retries <num>\n"
+        "\t--challenge-timeout <num>\t--challenge-retries <num>\n"
+            "\t\t\t\t分别指定寻找服务器（EAPOL-Start）、回应用户名、回应密码阶段的固定超时时间（秒，可为小数）与最大重试次数\n"
+            "\t\t\t\t指定超时时间后该阶段不再根据服务器响应时间调整超时 [默认同 --stage-timeout 与 --max-retries]\n"
         "\t--pid-file <...>\tPID 文件路径，设为none可禁用 [默认" DEFAULT_PIDFILE "]\n"
         "\t--conf-file <...>\t配置文件路径 [默认" DEFAULT_CONFFILE "]\n"
         "\t--if-impl <...>\t\t选择此网络操作模块，仅允许选择一次 [默认为第一个可用的模块]\n"
+        "\t--hash-provider <...>\t计算 MD5 所用的模块：auto、builtin、af_alg 或 openssl [默认auto，即启动时测试并选择最快的]\n"
         "\t--pkt-plugin <...>\t启用此名称的数据包修改器，可启用多次、多个 [默认无]\n"
         "\t--module <...>\t\t同上\n"
             "\t\t\t\t当命令行选项中存在 --module 或 --pkt-plugin 时，配置文件中的所有 module= 行都将被忽略\n"
@@ -119,6 +131,19 @@ static void print_cmdline_help() {
     _exit(EXIT_SUCCESS);
 }
 
+/*
+ * Timeouts are given in seconds, fractions allowed.
+ * Return `old_ms` if the argument is invalid.
+ */
+static int parse_timeout_ms(const char* argument, int old_ms) {
+    int _timeout_ms = secs_str2ms(argument);
+    if (_timeout_ms <= 0) {
+        PR_WARN("超时时间无效，已忽略：%s", argument);
+        return old_ms;
+    }
+    return _timeout_ms;
+}
+
 static void parse_one_opt(const char* option, const char* argument) {
 #define ISOPT(x) (strcmp(option, x) == 0)
 
@@ -139,6 +164,8 @@ static void parse_one_opt(const char* option, const char* argument) {
         insert_data(&g_prog_config.packet_plugin_list, (void*)argument);
     } else if (ISOPT("if-impl")) {
         COPY_N_ARG_TO(g_prog_config.if_impl, IFNAMSIZ);
+    } else if (ISOPT("hash-provider")) {
+        COPY_N_ARG_TO(g_prog_config.hash_provider, IFNAMSIZ);
     } else if (ISOPT("save")) {
         g_prog_config.save_now = 1;
     } else if (ISOPT("help")) {
@@ -152,7 +179,19 @@ static void parse_one_opt(const char* option, const char* argument) {
     } else if (ISOPT("wait-after-fail")) {
         g_prog_config.wait_after_fail_secs = atoi(argument);
     } else if (ISOPT("stage-timeout")) {
-        g_prog_config.stage_timeout = atoi(argument);
+        g_prog_config.stage_timeout_ms = parse_timeout_ms(argument, g_prog_config.stage_timeout_ms);
+    } else if (ISOPT("start-timeout")) {
+        g_prog_config.start_policy.timeout_ms = parse_timeout_ms(argument, g_prog_config.start_policy.timeout_ms);
+    } else if (ISOPT("start-retries")) {
+        g_prog_config.start_policy.max_retries = atoi(argument);
+    } else if (ISOPT("identity-timeout")) {
+        g_prog_config.identity_policy.timeout_ms = parse_timeout_ms(argument, g_prog_config.identity_policy.timeout_ms);
+    } else if (ISOPT("identity-retries")) {
+        g_prog_config.identity_policy.max_retries = atoi(argument);
+    } else if (ISOPT("challenge-timeout")) {
+        g_prog_config.challenge_policy.timeout_ms = parse_timeout_ms(argument, g_prog_config.challenge_policy.timeout_ms);
+    } else if (ISOPT("challenge-retries")) {
+        g_prog_config.challenge_policy.max_retries = atoi(argument);
     } else if (ISOPT("kill")) {
         if (argument == NULL)
             g_prog_config.kill_type = KILL_ONLY; /* 结束其他实例并退出 */
@@ -190,8 +229,15 @@ RESULT parse_cmdline_opts(int argc, char* argv[]) {
 	    { "proxy-lan-iface", required_argument, NULL, 'z' },
 	    { "auth-round", required_argument, NULL, 'j' },
 	    { "max-retries", required_argument, NULL, 0},
+	    { "start-timeout", required_argument, NULL, 0},
+	    { "start-retries", required_argument, NULL, 0},
+	    { "identity-timeout", required_argument, NULL, 0},
+	    { "identity-retries", required_argument, NULL, 0},
+	    { "challenge-timeout", required_argument, NULL, 0},
+	    { "challenge-retries", required_argument, NULL, 0},
 	    { "pid-file", required_argument, NULL, 0},
 	    { "if-impl", required_argument, NULL, 0},
+	    { "hash-provider", required_argument, NULL, 0},
 	    { "pkt-plugin", required_argument, NULL, 0},
 	    { "module", required_argument, NULL, 0},
 	    { "log-file", required_argument, NULL, 0},
@@ -250,6 +296,23 @@ RESULT parse_config_file(const char* filepath) {
     return SUCCESS;
 }
 
+/*
+ * Save "<prefix>-timeout" and "<prefix>-retries" if they are set
+ */
+static void save_state_policy(const char* prefix, const STATE_POLICY* policy) {
+    char _key[32];
+    char itoa_buf[12];
+
+    if (policy->timeout_ms != STATE_POLICY_DEFAULT) {
+        snprintf(_key, sizeof(_key), "%s-timeout", prefix);
+        conf_parser_add_value(_key, ms2secs_str(policy->timeout_ms, itoa_buf));
+    }
+    if (policy->max_retries != STATE_POLICY_DEFAULT) {
+        snprintf(_key, sizeof(_key), "%s-retries", prefix);
+        conf_parser_add_value(_key, my_itoa(policy->max_retries, itoa_buf, 10));
+    }
+}
+
 RESULT save_config_file() {
     char itoa_buf[12]; /* -2147483647\0 */
     conf_parser_free(); /* Save some meaningless lookup / free */
@@ -259,11 +322,17 @@ RESULT save_config_file() {
     save_active_packet_plugin_list();
     conf_parser_add_value("daemonize", my_itoa(g_prog_config.daemon_type, itoa_buf, 10));
     conf_parser_add_value("if-impl", get_if_impl()->name);
+    if (g_prog_config.hash_provider) {
+        conf_parser_add_value("hash-provider", g_prog_config.hash_provider);
+    }
     conf_parser_add_value("max-fail", my_itoa(g_prog_config.max_failures, itoa_buf, 10));
     conf_parser_add_value("max-retries", my_itoa(g_prog_config.max_retries, itoa_buf, 10));
     conf_parser_add_value("no-auto-reauth", g_prog_config.restart_on_logoff ? "0" : "1");
     conf_parser_add_value("wait-after-fail", my_itoa(g_prog_config.wait_after_fail_secs, itoa_buf, 10));
-    conf_parser_add_value("stage-timeout", my_itoa(g_prog_config.stage_timeout, itoa_buf, 10));
+    conf_parser_add_value("stage-timeout", ms2secs_str(g_prog_config.stage_timeout_ms, itoa_buf));
+    save_state_policy("start", &g_prog_config.start_policy);
+    save_state_policy("identity", &g_prog_config.identity_policy);
+    save_state_policy("challenge", &g_prog_config.challenge_policy);
     conf_parser_add_value("proxy-lan-iface", g_proxy_config.lan_ifname);
     conf_parser_add_value("auth-round", my_itoa(g_prog_config.auth_round, itoa_buf, 10));
     conf_parser_add_value("pid-file", g_prog_config.pidfile);
@@ -300,6 +369,7 @@ void free_config() {
     chk_free((void**)&g_prog_config.logfile);
     chk_free((void**)&g_prog_config.conffile);
     chk_free((void**)&g_prog_config.if_impl);
+    chk_free((void**)&g_prog_config.hash_provider);
     list_destroy(&g_prog_config.packet_plugin_list, FALSE);
 
     chk_free((void**)&g_eap_config.username);
@@ -6,6 +6,12 @@ PLUGIN_MODULES := \
 # Linux
 PLUGIN_MODULES += if_impl_sockraw
 
+# Linux 5.3+, needs root (CAP_NET_ADMIN + CAP_BPF). Use with --if-impl xdp
+# PLUGIN_MODULES += if_impl_xdp
+
+# Linux 6.0+. Use with --if-impl uring
+# PLUGIN_MODULES += if_impl_uring
+
 # macOS / BSD
 # PLUGIN_MODULES += if_impl_bpf
 
@@ -21,6 +27,9 @@ ENABLE_ICONV  := true
 ENABLE_GBCONV := false
 STATIC_BUILD  := false
 
+# Compute MD5 with OpenSSL libcrypto as an option of --hash-provider
+ENABLE_OPENSSL := false
+
 # If your platform has iconv_* integrated into libc, change to false
 # Affects dynamic linking
 LIBICONV_STANDALONE := false
@@ -10,18 +10,48 @@
 #include "eth_frame.h"
 #include "net_util.h"
 #include "sched_alarm.h"
+#include "rtt_estimator.h"
+#include "misc.h"
 
 #include <stdlib.h>
 
+/*
+ * Bounds of retransmission timeout. Stage timeout is used before we get any RTT sample.
+ */
+#define STATE_RTO_MIN_MS 200
+#define STATE_RTO_MAX_MS 60000
+
+/*
+ * The last response we sent, and which request it answers.
+ * If it's not a response to any request (EAPOL-Start/Logoff), `eapol_type` is
+ * that of the frame itself and other request fields are all 0.
+ */
+typedef struct _response_cache {
+    int valid;
+    uint8_t eapol_type;
+    uint8_t eap_code;
+    uint8_t eap_id;
+    uint8_t eap_type;
+    size_t len;
+    uint8_t buf[FRAME_BUF_SIZE];
+} RESPONSE_CACHE;
+
 typedef struct _state_mach_priv {
     int state_last_count; // Number of timeouts occured in this state
+    uint64_t state_entered_usecs; // When the current state was entered
+    int state_give_up; // The watchdog expires when it's time to give up in this state
     int auth_round; // Current authentication round
     int fail_count;
     int state_alarm_id;
+    uint64_t request_sent_usecs; // When the last response was sent, 0 = not to be sampled
+    RTT_ESTIMATOR rtt;
+    RESPONSE_CACHE response_cache;
     uint8_t local_mac[6];
     uint8_t server_mac[6];
     EAP_STATE state;
-    ETH_EAP_FRAME* last_recv_frame;
+    ETH_EAP_FRAME* last_request; // Answered again on timeouts. NULL or &last_request_frame
+    ETH_EAP_FRAME last_request_frame;
+    uint8_t last_request_buf[FRAME_BUF_SIZE];
     PACKET_BUILDER* packet_builder;
 } STATE_MACH_PRIV;
 
@@ -30,6 +60,7 @@ static STATE_MACH_PRIV g_priv;
 typedef struct _state_trans {
     EAP_STATE state;
     RESULT (*trans_func)(ETH_EAP_FRAME* frame);
+    STATE_POLICY policy; /* Timeout and retries in this state, filled in from config on init */
 } STATE_TRANSITION;
 
 static RESULT trans_to_preparing(ETH_EAP_FRAME* frame);
@@ -52,21 +83,71 @@ static STATE_TRANSITION g_transition_table[] = {
     {EAP_STATE_FAILURE, trans_to_failure},
 };
 
+/*
+ * Resolve the timeout/retry policy of each state.
+ * timeout_ms = STATE_POLICY_DEFAULT means the adaptive RTO is used.
+ */
+static void load_state_policies() {
+    int i;
+    PROG_CONFIG* _cfg = get_program_config();
+    STATE_POLICY* _policy;
+
+    for (i = 0; i < sizeof(g_transition_table) / sizeof(STATE_TRANSITION); ++i) {
+        switch (g_transition_table[i].state) {
+            case EAP_STATE_START_SENT:
+                _policy = &_cfg->start_policy;
+                break;
+            case EAP_STATE_IDENTITY_SENT:
+                _policy = &_cfg->identity_policy;
+                break;
+            case EAP_STATE_CHALLENGE_SENT:
+                _policy = &_cfg->challenge_policy;
+                break;
+            default:
+                _policy = NULL;
+                break;
+        }
+        g_transition_table[i].policy.timeout_ms = _policy ? _policy->timeout_ms : STATE_POLICY_DEFAULT;
+        g_transition_table[i].policy.max_retries =
+            (_policy && _policy->max_retries != STATE_POLICY_DEFAULT) ? _policy->max_retries : _cfg->max_retries;
+    }
+}
+
+static const STATE_POLICY* get_state_policy(EAP_STATE state) {
+    int i;
+    for (i = 0; i < sizeof(g_transition_table) / sizeof(STATE_TRANSITION); ++i) {
+        if (state == g_transition_table[i].state) {
+            return &g_transition_table[i].policy;
+        }
+    }
+    return NULL;
+}
+
 static const uint8_t BCAST_ADDR[6] = {0x01,0x80,0xc2,0x00,0x00,0x03};
 static const uint8_t ETH_P_PAE_BYTES[2] = {0x88, 0x8e};
 
 #define PRIV (&g_priv) // I like pointers!
 
 static void disable_state_watchdog();
+static void response_cache_invalidate();
+
+#define CFG_STAGE_TIMEOUT ((get_program_config())->stage_timeout_ms)
 
 static void eap_state_machine_reset() {
     disable_state_watchdog();
-    free_frame(&PRIV->last_recv_frame);
+    response_cache_invalidate();
+    rtt_estimator_reset_backoff(&PRIV->rtt);
+    PRIV->last_request = NULL;
     PRIV->state_last_count = 0;
     PRIV->state = EAP_STATE_UNKNOWN; // If called by a transition func, this won't take effect
     PRIV->auth_round = 1;
     PRIV->fail_count = 0;
     memmove(PRIV->server_mac, BCAST_ADDR, sizeof(BCAST_ADDR));
+
+    IF_IMPL* _if_impl = get_if_impl();
+    if (_if_impl->set_peer_mac) {
+        _if_impl->set_peer_mac(_if_impl, NULL);
+    }
 }
 
 RESULT eap_state_machine_init() {
@@ -76,6 +157,9 @@ RESULT eap_state_machine_init() {
     _if_impl->get_ifname(_if_impl, buf, IFNAMSIZ);
     obtain_iface_mac(buf, PRIV->local_mac);
 
+    load_state_policies();
+    rtt_estimator_init(&PRIV->rtt, CFG_STAGE_TIMEOUT, STATE_RTO_MIN_MS,
+                       CFG_STAGE_TIMEOUT > STATE_RTO_MAX_MS ? CFG_STAGE_TIMEOUT : STATE_RTO_MAX_MS);
     eap_state_machine_reset();
 
     PRIV->packet_builder = packet_builder_get();
@@ -86,7 +170,7 @@ RESULT eap_state_machine_init() {
 void eap_state_machine_destroy() {
     packet_builder_destroy();
     PRIV->packet_builder = NULL;
-    free_frame(&PRIV->last_recv_frame);
+    PRIV->last_request = NULL;
 }
 
 static inline void set_outgoing_eth_fields(PACKET_BUILDER* builder) {
@@ -95,6 +179,96 @@ static inline void set_outgoing_eth_fields(PACKET_BUILDER* builder) {
     builder->set_eth_field(builder, FIELD_ETH_PROTO, ETH_P_PAE_BYTES);
 }
 
+/*
+ * Remember when the response is sent, to measure RTT when server replies.
+ * Retransmissions are not sampled (Karn's algorithm): the reply may be for any copy.
+ */
+static void mark_request_sent() {
+    PRIV->request_sent_usecs = PRIV->state_last_count ? 0 : get_monotonic_usecs();
+}
+
+static void take_rtt_sample(ETH_EAP_FRAME* frame) {
+    uint64_t _recv_usecs = frame->recv_usecs ? frame->recv_usecs : get_monotonic_usecs();
+
+    if (PRIV->request_sent_usecs == 0) {
+        return;
+    }
+    if (_recv_usecs > PRIV->request_sent_usecs) {
+        rtt_estimator_sample(&PRIV->rtt, _recv_usecs - PRIV->request_sent_usecs);
+        PR_DBG("RTT = %d us, RTO = %d ms", (int)(_recv_usecs - PRIV->request_sent_usecs),
+                rtt_estimator_rto_ms(&PRIV->rtt));
+    }
+    PRIV->request_sent_usecs = 0;
+}
+
+/*
+ * Response cache
+ *
+ * Retransmissions (by watchdog, or for duplicated requests from server) send
+ * exactly the same bytes as last time, without building the frame and calling
+ * plugins again. The cache is only valid in current state.
+ */
+static void response_cache_invalidate() {
+    PRIV->response_cache.valid = FALSE;
+}
+
+/*
+ * `eapol_type` is the type of the frame to send, only used when `request` is NULL
+ */
+static int response_cache_match(const ETH_EAP_FRAME* request, EAPOL_TYPE eapol_type) {
+    RESPONSE_CACHE* _cache = &PRIV->response_cache;
+
+    if (!_cache->valid) {
+        return FALSE;
+    }
+    if (request == NULL) {
+        /* No request has EAP code 0, so these never match one */
+        return _cache->eapol_type == eapol_type && _cache->eap_code == 0
+                && _cache->eap_id == 0 && _cache->eap_type == 0;
+    }
+    return _cache->eapol_type == request->header->eapol_hdr.type[0]
+            && _cache->eap_code == request->header->eap_hdr.code[0]
+            && _cache->eap_id == request->header->eap_hdr.id[0]
+            && _cache->eap_type == request->header->eap_hdr.type[0];
+}
+
+static void response_cache_save(const ETH_EAP_FRAME* request, const ETH_EAP_FRAME* response) {
+    RESPONSE_CACHE* _cache = &PRIV->response_cache;
+
+    if (response->actual_len > sizeof(_cache->buf)) {
+        _cache->valid = FALSE;
+        return;
+    }
+    _cache->eapol_type = request ? request->header->eapol_hdr.type[0] : response->header->eapol_hdr.type[0];
+    _cache->eap_code = request ? request->header->eap_hdr.code[0] : 0;
+    _cache->eap_id = request ? request->header->eap_hdr.id[0] : 0;
+    _cache->eap_type = request ? request->header->eap_hdr.type[0] : 0;
+    _cache->len = response->actual_len;
+    memmove(_cache->buf, response->content, response->actual_len);
+    _cache->valid = TRUE;
+}
+
+/*
+ * Return: TRUE if the cached response for `request` (or frame of `eapol_type` if NULL) is sent
+ */
+static int response_cache_resend(const ETH_EAP_FRAME* request, EAPOL_TYPE eapol_type) {
+    ETH_EAP_FRAME _response;
+    IF_IMPL* _if_impl = get_if_impl();
+
+    if (!response_cache_match(request, eapol_type)) {
+        return FALSE;
+    }
+
+    _response.actual_len = PRIV->response_cache.len;
+    _response.buffer_len = sizeof(PRIV->response_cache.buf);
+    _response.content = PRIV->response_cache.buf;
+    mark_request_sent();
+    if (IS_FAIL(_if_impl->send_frame(_if_impl, &_response))) {
+        return FALSE; /* Try building a new one */
+    }
+    return TRUE;
+}
+
 /*
  * Packet senders
  *
@@ -105,6 +279,10 @@ static RESULT state_mach_send_identity_response(ETH_EAP_FRAME* request) {
     ETH_EAP_FRAME _response;
     IF_IMPL* _if_impl = get_if_impl();
 
+    if (response_cache_resend(request, EAP_PACKET)) {
+        return SUCCESS;
+    }
+
     set_outgoing_eth_fields(PRIV->packet_builder);
     PRIV->packet_builder->set_eap_fields(PRIV->packet_builder,
                                 EAP_PACKET, EAP_RESPONSE,
@@ -118,6 +296,8 @@ static RESULT state_mach_send_identity_response(ETH_EAP_FRAME* request) {
         PR_ERR("插件在准备发送 Response-Identity 包时出现错误");
         return FAILURE;
     }
+    response_cache_save(request, &_response);
+    mark_request_sent();
     if (IS_FAIL(_if_impl->send_frame(_if_impl, &_response))) {
         PR_ERR("发送 Response-Identity 包时出现错误");
         return FAILURE;
@@ -130,6 +310,10 @@ static RESULT state_mach_send_challenge_response(ETH_EAP_FRAME* request) {
     ETH_EAP_FRAME _response;
     IF_IMPL* _if_impl = get_if_impl();
 
+    if (response_cache_resend(request, EAP_PACKET)) {
+        return SUCCESS;
+    }
+
     set_outgoing_eth_fields(PRIV->packet_builder);
     PRIV->packet_builder->set_eap_fields(PRIV->packet_builder,
                                 EAP_PACKET, EAP_RESPONSE,
@@ -146,6 +330,8 @@ static RESULT state_mach_send_challenge_response(ETH_EAP_FRAME* request) {
         PR_ERR("插件在准备发送 Response-MD5-Challenge 包时出现错误");
         return FAILURE;
     }
+    response_cache_save(request, &_response);
+    mark_request_sent();
     if (IS_FAIL(_if_impl->send_frame(_if_impl, &_response))) {
         PR_ERR("发送 Response-MD5-Challenge 包时出现错误");
         return FAILURE;
@@ -158,6 +344,10 @@ static RESULT state_mach_send_eapol_simple(EAPOL_TYPE eapol_type) {
     ETH_EAP_FRAME _response;
     IF_IMPL* _if_impl = get_if_impl();
 
+    if (response_cache_resend(NULL, eapol_type)) {
+        return SUCCESS;
+    }
+
     set_outgoing_eth_fields(PRIV->packet_builder);
     PRIV->packet_builder->set_eap_fields(PRIV->packet_builder,
                                 eapol_type, 0,
@@ -171,6 +361,8 @@ static RESULT state_mach_send_eapol_simple(EAPOL_TYPE eapol_type) {
         PR_ERR("插件在准备发送 %s 包时出现错误", str_eapol_type(eapol_type));
         return FAILURE;
     }
+    response_cache_save(NULL, &_response);
+    mark_request_sent();
     if (IS_FAIL(_if_impl->send_frame(_if_impl, &_response))) {
         PR_ERR("发送 %s 包时出现错误", str_eapol_type(eapol_type));
         return FAILURE;
@@ -231,12 +423,20 @@ static RESULT state_mach_process_failure(ETH_EAP_FRAME* frame) {
  * and switch to next state (to send response)
  */
 void eap_state_machine_recv_handler(ETH_EAP_FRAME* frame) {
-    /* Keep a copy of the frame, since if_impl may not hold it */
-    if (PRIV->last_recv_frame != NULL) {
-        free_frame(&PRIV->last_recv_frame);
+    /*
+     * `frame` may be in a ring of if_impl, only valid during this call.
+     * Requests are kept for the watchdog, others are used as they are.
+     */
+    if (frame->header->eapol_hdr.type[0] == EAP_PACKET
+            && frame->header->eap_hdr.code[0] == EAP_REQUEST) {
+        PRIV->last_request_frame.content = PRIV->last_request_buf;
+        PRIV->last_request_frame.buffer_len = sizeof(PRIV->last_request_buf);
+        if (IS_FAIL(frame_copy(&PRIV->last_request_frame, frame))) {
+            return;
+        }
+        frame = PRIV->last_request = &PRIV->last_request_frame;
     }
-    PRIV->last_recv_frame = frame_duplicate(frame);
-    packet_plugin_on_frame_received(PRIV->last_recv_frame);
+    packet_plugin_on_frame_received(frame);
 
     EAPOL_TYPE _eapol_type = frame->header->eapol_hdr.type[0];
     if (_eapol_type == EAP_PACKET) {
@@ -249,7 +449,15 @@ void eap_state_machine_recv_handler(ETH_EAP_FRAME* frame) {
                 /*
                  * Store server's MAC addr, do not use broadcast after.
                  */
-                memmove(PRIV->server_mac, frame->header->eth_hdr.src_mac, 6);
+                if (memcmp(PRIV->server_mac, frame->header->eth_hdr.src_mac, 6) != 0) {
+                    IF_IMPL* _if_impl = get_if_impl();
+
+                    memmove(PRIV->server_mac, frame->header->eth_hdr.src_mac, 6);
+                    if (_if_impl->set_peer_mac) {
+                        _if_impl->set_peer_mac(_if_impl, PRIV->server_mac);
+                    }
+                }
+                take_rtt_sample(frame);
                 if (_eap_type == IDENTITY) {
                     switch_to_state(EAP_STATE_IDENTITY_SENT, frame);
                 } else if (_eap_type == MD5_CHALLENGE) {
@@ -257,9 +465,11 @@ void eap_state_machine_recv_handler(ETH_EAP_FRAME* frame) {
                 }
                 break;
             case EAP_SUCCESS:
+                take_rtt_sample(frame);
                 switch_to_state(EAP_STATE_SUCCESS, frame);
                 break;
             case EAP_FAILURE:
+                take_rtt_sample(frame);
                 switch_to_state(EAP_STATE_FAILURE, frame);
                 break;
             default:
@@ -268,28 +478,78 @@ void eap_state_machine_recv_handler(ETH_EAP_FRAME* frame) {
     }
 }
 
-#define CFG_STAGE_TIMEOUT ((get_program_config())->stage_timeout)
+/*
+ * States with fixed timeouts set by user do not use the estimated RTO
+ */
+static int state_uses_rto(EAP_STATE state) {
+    const STATE_POLICY* _policy = get_state_policy(state);
+    return _policy == NULL || _policy->timeout_ms == STATE_POLICY_DEFAULT;
+}
+
+/*
+ * How long to wait in a state using RTO before giving up, 0 = forever.
+ * As long as `max_retries` stage timeouts, like before RTO was estimated:
+ * a short RTO only means retransmitting sooner, not giving up sooner.
+ */
+static uint64_t state_give_up_usecs(EAP_STATE state) {
+    const STATE_POLICY* _policy = get_state_policy(state);
+    int _max_retries = _policy ? _policy->max_retries : get_program_config()->max_retries;
+
+    return _max_retries > 0 ? (uint64_t)_max_retries * CFG_STAGE_TIMEOUT * 1000 : 0;
+}
+
 /*
  * Re-transmit the response to last frame, in case the authentication server
- * stops responding.
+ * stops responding. Wait twice as long for the next one if RTO is used.
  */
-static void reset_state_watchdog();
+static void reset_state_watchdog(EAP_STATE state);
 static void state_watchdog(void* unused) {
-    switch_to_state(PRIV->state, PRIV->last_recv_frame);
-    reset_state_watchdog();
+    if (PRIV->state_give_up) {
+        PR_ERR("在 %d 状态已经等待了 %d 秒，达到指定时间，正在退出……",
+                PRIV->state, (int)(state_give_up_usecs(PRIV->state) / 1000000));
+        exit(EXIT_FAILURE);
+    }
+    if (state_uses_rto(PRIV->state)) {
+        rtt_estimator_backoff(&PRIV->rtt);
+    }
+    switch_to_state(PRIV->state, PRIV->last_request);
+    reset_state_watchdog(PRIV->state);
 }
 
 /*
- * Set a new watchdog for current state
+ * Set a new watchdog for `state`.
+ * Timeout is the fixed one in its policy, or the RTO estimated from previous
+ * exchanges with the server, but not past the time to give up.
  */
-static void reset_state_watchdog() {
+static void reset_state_watchdog(EAP_STATE state) {
+    uint64_t _give_up_usecs, _waited_usecs;
+    int _timeout_ms;
+
+    PRIV->state_give_up = FALSE;
+    if (state_uses_rto(state)) {
+        _timeout_ms = rtt_estimator_rto_ms(&PRIV->rtt);
+        _give_up_usecs = state_give_up_usecs(state);
+        _waited_usecs = get_monotonic_usecs() - PRIV->state_entered_usecs;
+        if (_give_up_usecs) {
+            _give_up_usecs = _give_up_usecs > _waited_usecs ? _give_up_usecs - _waited_usecs : 0;
+            /* No point retransmitting with no time left for the reply */
+            if ((uint64_t)(_timeout_ms + STATE_RTO_MIN_MS) * 1000 > _give_up_usecs) {
+                _timeout_ms = (_give_up_usecs + 999) / 1000;
+                PRIV->state_give_up = TRUE;
+            }
+        }
+    } else {
+        _timeout_ms = get_state_policy(state)->timeout_ms;
+    }
+
     unschedule_alarm(PRIV->state_alarm_id);
-    PRIV->state_alarm_id = schedule_alarm(CFG_STAGE_TIMEOUT, state_watchdog, NULL);
+    PRIV->state_alarm_id = schedule_alarm_ms(_timeout_ms, state_watchdog, NULL);
 }
 
 static void disable_state_watchdog() {
     unschedule_alarm(PRIV->state_alarm_id);
     PRIV->state_alarm_id = 0;
+    PRIV->request_sent_usecs = 0;
 }
 
 /*
@@ -344,10 +604,12 @@ RESULT switch_to_state(EAP_STATE state, ETH_EAP_FRAME* frame) {
     int i;
 
     if (PRIV->state == state) {
-        PROG_CONFIG* _cfg = get_program_config();
+        const STATE_POLICY* _policy = get_state_policy(state);
+        int _max_retries = _policy ? _policy->max_retries : get_program_config()->max_retries;
         PRIV->state_last_count++;
-        if (PRIV->state_last_count == _cfg->max_retries) {
-            PR_ERR("在 %d 状态已经停留了 %d 次，达到指定次数，正在退出……", PRIV->state, _cfg->max_retries);
+        /* With RTO, the watchdog gives up by time instead */
+        if (!state_uses_rto(state) && PRIV->state_last_count == _max_retries) {
+            PR_ERR("在 %d 状态已经停留了 %d 次，达到指定次数，正在退出……", PRIV->state, _max_retries);
             exit(EXIT_FAILURE);
         }
     } else {
@@ -357,7 +619,9 @@ RESULT switch_to_state(EAP_STATE state, ETH_EAP_FRAME* frame) {
          * e.g. after success
          */
         PRIV->state_last_count = 0;
-        reset_state_watchdog();
+        PRIV->state_entered_usecs = get_monotonic_usecs();
+        response_cache_invalidate();
+        reset_state_watchdog(state);
     }
 
     for (i = 0; i < sizeof(g_transition_table) / sizeof(STATE_TRANSITION); ++i) {
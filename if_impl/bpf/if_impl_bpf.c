@@ -139,6 +139,9 @@ RESULT bpf_start_capture(struct _if_impl* this) {
     while (read(PRIV->bpffd, (void*)bpfbuf, BPF_BUFFER_SIZE) > 0 && PRIV->stop_flag == 0) {
         frame.actual_len = ((struct bpf_hdr*)bpfbuf)->bh_caplen;
         frame.content = bpfbuf + ((struct bpf_hdr*)bpfbuf)->bh_hdrlen;
+        frame.recv_usecs = realtime_to_monotonic_usecs(
+                (uint64_t)((struct bpf_hdr*)bpfbuf)->bh_tstamp.tv_sec * 1000000
+                + ((struct bpf_hdr*)bpfbuf)->bh_tstamp.tv_usec);
         PRIV->handler(&frame);
     }
 
@@ -6,6 +6,8 @@
 #include "if_impl.h"
 #include "minieap_common.h"
 #include "logging.h"
+#include "misc.h"
+#include "event_loop.h"
 
 #include <pcap.h>
 #include <net/if.h>
@@ -27,6 +29,8 @@ static void libpcap_packet_handler(uint8_t* vthis, const struct pcap_pkthdr* pkt
 
     _frame.buffer_len = _frame.actual_len = pkthdr->caplen;
     _frame.content = (uint8_t*)packet;
+    _frame.recv_usecs = realtime_to_monotonic_usecs(
+                (uint64_t)pkthdr->ts.tv_sec * 1000000 + pkthdr->ts.tv_usec);
     PRIV->handler(&_frame);
 }
 
@@ -72,6 +76,36 @@ RESULT libpcap_prepare_interface(struct _if_impl* this) {
     return SUCCESS;
 }
 
+#ifdef __linux__
+static void libpcap_on_readable(int fd, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    pcap_dispatch(PRIV->pcapdev, -1, libpcap_packet_handler, (uint8_t*)this);
+}
+
+RESULT libpcap_start_capture(struct _if_impl* this) {
+    char _err_buf[PCAP_ERRBUF_SIZE] = {0};
+    int _fd;
+
+    if (pcap_setnonblock(PRIV->pcapdev, 1, _err_buf) < 0
+            || (_fd = pcap_get_selectable_fd(PRIV->pcapdev)) < 0) {
+        PR_ERR("libpcap 无法切换到非阻塞模式： %s", _err_buf);
+        return FAILURE;
+    }
+
+    if (IS_FAIL(event_loop_add_fd(_fd, libpcap_on_readable, this))) {
+        return FAILURE;
+    }
+
+    RESULT ret = event_loop_run();
+    event_loop_remove_fd(_fd);
+    return ret;
+}
+
+RESULT libpcap_stop_capture(struct _if_impl* this) {
+    event_loop_stop();
+    return SUCCESS;
+}
+#else
 RESULT libpcap_start_capture(struct _if_impl* this) {
     pcap_loop(PRIV->pcapdev, -1, libpcap_packet_handler, (uint8_t*)this);
     return SUCCESS; /* No use if it's blocking... */
@@ -85,6 +119,7 @@ RESULT libpcap_stop_capture(struct _if_impl* this) {
         return FAILURE;
     }
 }
+#endif
 
 RESULT libpcap_send_frame(struct _if_impl* this, ETH_EAP_FRAME* frame) {
     if (!PRIV->pcapdev || pcap_sendpacket(PRIV->pcapdev, frame->content, frame->actual_len) < 0) {
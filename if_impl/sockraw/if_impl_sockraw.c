@@ -6,23 +6,83 @@
 #include "minieap_common.h"
 #include "logging.h"
 #include "misc.h"
+#include "event_loop.h"
+#include "net_util.h"
 
 #include <netinet/in.h>
 #include <linux/if_ether.h> // ETH_ALEN
 #include <linux/if_packet.h>
+#include <linux/filter.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <stdlib.h>
 
+/*
+ * TPACKET_V3 receive ring. The kernel hands a block over when it is full,
+ * or RX_RING_BLOCK_TOV_MS after its first frame arrived.
+ * Block size is a multiple of all common page sizes.
+ */
+#define RX_RING_BLOCK_SIZE (1 << 16)
+#define RX_RING_BLOCK_NR 8
+#define RX_RING_FRAME_SIZE 2048
+#define RX_RING_BLOCK_TOV_MS 2
+#define RX_RING_SIZE (RX_RING_BLOCK_SIZE * RX_RING_BLOCK_NR)
+
+/*
+ * Transmit ring, one block of fixed size slots. Frames sent in one event loop
+ * wakeup are queued there and flushed by one send() before the loop sleeps.
+ * Frame data starts right after the aligned header unless PACKET_TX_HAS_OFF is set.
+ */
+#define TX_RING_SIZE (1 << 16)
+#define TX_RING_FRAME_SIZE 2048
+#define TX_RING_FRAME_NR (TX_RING_SIZE / TX_RING_FRAME_SIZE)
+#define TX_RING_DATA_OFFSET TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#define TX_RING_SLOT(i) ((struct tpacket3_hdr*)(PRIV->tx_ring + (i) * TX_RING_FRAME_SIZE))
+
+/*
+ * Without the rings, frames are received by recvmmsg() and sent by sendmmsg()
+ * in batches of this size, flushed in the same way as the TX ring
+ */
+#define MMSG_BATCH 8
+
+/* Longest program sockraw_update_filter() generates */
+#define FILTER_MAX_LEN 32
+
+static const uint8_t PAE_GROUP_ADDR[6] = {0x01,0x80,0xc2,0x00,0x00,0x03};
+static const uint8_t RJ_GROUP_ADDR[6] = {0x01,0xd0,0xf8,0x00,0x00,0x03};
+static const uint8_t ETH_BCAST_ADDR[6] = {0xff,0xff,0xff,0xff,0xff,0xff};
+
 typedef struct _if_impl_sockraw_priv {
     char ifname[IFNAMSIZ];
     int sockfd; /* Internal use */
     int if_index; /* Index of this interface */
-    int stop_flag; /* Set to break out of recv loop */
     int promisc;
     short proto; /* Stored as host byte order */
     void (*handler)(ETH_EAP_FRAME* frame); /* Packet handler */
+    uint8_t* ring; /* Both rings are in one mapping, RX first */
+    size_t ring_size;
+    uint8_t* rx_ring; /* NULL = recvmsg() each frame */
+    int rx_block; /* Next block to read in the ring */
+    uint8_t* tx_ring; /* NULL = sendmmsg() batches */
+    int tx_frame; /* Next slot to fill */
+    int tx_pending; /* Slots filled since last flush */
+    int tx_batch; /* Flushed by the event loop, not after each frame */
+    struct { /* recvmmsg() buffers */
+        struct mmsghdr msgs[MMSG_BATCH];
+        struct iovec iovs[MMSG_BATCH];
+        uint8_t cmsgs[MMSG_BATCH][CMSG_SPACE(sizeof(struct timespec))];
+        uint8_t bufs[MMSG_BATCH][FRAME_BUF_SIZE];
+    } rx_mmsg;
+    struct { /* sendmmsg() queue */
+        struct mmsghdr msgs[MMSG_BATCH];
+        struct iovec iovs[MMSG_BATCH];
+        uint8_t bufs[MMSG_BATCH][FRAME_BUF_SIZE];
+        int pending;
+    } tx_mmsg;
+    int has_peer_mac;
+    uint8_t peer_mac[6]; /* Only accept frames from it, if set */
 } sockraw_priv;
 
 #define PRIV ((sockraw_priv*)(this->priv))
@@ -73,67 +133,472 @@ RESULT sockraw_setup_capture_params(struct _if_impl* this, unsigned short eth_pr
     return SUCCESS;
 }
 
+/*
+ * Map a PACKET_RX_RING and a PACKET_TX_RING, so frames are exchanged through
+ * memory shared with the kernel, without a syscall or copy for each of them.
+ * Either one can be missing, TPACKET_V3 transmit needs Linux 4.11.
+ */
+static RESULT sockraw_setup_rings(struct _if_impl* this) {
+    int _ver = TPACKET_V3;
+    int _has_rx, _has_tx;
+    struct tpacket_req3 _rx_req, _tx_req;
+
+    memset(&_rx_req, 0, sizeof(_rx_req));
+    _rx_req.tp_block_size = RX_RING_BLOCK_SIZE;
+    _rx_req.tp_block_nr = RX_RING_BLOCK_NR;
+    _rx_req.tp_frame_size = RX_RING_FRAME_SIZE;
+    _rx_req.tp_frame_nr = RX_RING_SIZE / RX_RING_FRAME_SIZE;
+    _rx_req.tp_retire_blk_tov = RX_RING_BLOCK_TOV_MS;
+
+    memset(&_tx_req, 0, sizeof(_tx_req));
+    _tx_req.tp_block_size = TX_RING_SIZE;
+    _tx_req.tp_block_nr = 1;
+    _tx_req.tp_frame_size = TX_RING_FRAME_SIZE;
+    _tx_req.tp_frame_nr = TX_RING_FRAME_NR;
+
+    if (setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_VERSION, &_ver, sizeof(_ver)) < 0) {
+        PR_DBG("无法启用 TPACKET_V3，将逐帧收发: %s", strerror(errno));
+        return FAILURE;
+    }
+    if (!(_has_rx = setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_RX_RING, &_rx_req, sizeof(_rx_req)) == 0)) {
+        PR_DBG("无法启用 PACKET_RX_RING，将逐帧接收: %s", strerror(errno));
+    }
+    if (!(_has_tx = setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_TX_RING, &_tx_req, sizeof(_tx_req)) == 0)) {
+        PR_DBG("无法启用 PACKET_TX_RING，将逐帧发送: %s", strerror(errno));
+    }
+    if (!_has_rx && !_has_tx) {
+        return FAILURE;
+    }
+
+    PRIV->ring_size = (_has_rx ? RX_RING_SIZE : 0) + (_has_tx ? TX_RING_SIZE : 0);
+    PRIV->ring = mmap(NULL, PRIV->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, PRIV->sockfd, 0);
+    if (PRIV->ring == MAP_FAILED) {
+        PR_DBG("无法映射 PACKET_MMAP 环，将逐帧收发: %s", strerror(errno));
+        PRIV->ring = NULL;
+        PRIV->ring_size = 0;
+        /* Back to the socket queue */
+        memset(&_rx_req, 0, sizeof(_rx_req));
+        setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_RX_RING, &_rx_req, sizeof(_rx_req));
+        setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_TX_RING, &_rx_req, sizeof(_rx_req));
+        return FAILURE;
+    }
+
+    PRIV->rx_ring = _has_rx ? PRIV->ring : NULL;
+    PRIV->rx_block = 0;
+    PRIV->tx_ring = _has_tx ? PRIV->ring + (_has_rx ? RX_RING_SIZE : 0) : NULL;
+    PRIV->tx_frame = 0;
+    PRIV->tx_pending = 0;
+    return SUCCESS;
+}
+
+/*
+ * Emit BPF code accepting frames whose MAC address at `offset` is one of `macs`.
+ * Each address takes 4 instructions. A match jumps over the rest of them and
+ * the "reject" following them.
+ *
+ * Return: number of instructions emitted
+ */
+static int sockraw_filter_match_mac(struct sock_filter* code, int offset, const uint8_t** macs, int count) {
+    struct sock_filter* _pos = code;
+    int i;
+
+#define MAC_LO(mac) ((uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | mac[4] << 8 | mac[5])
+#define MAC_HI(mac) (mac[0] << 8 | mac[1])
+    for (i = 0; i < count; ++i) {
+        *_pos++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offset + 2);
+        *_pos++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, MAC_LO(macs[i]), 0, 2);
+        *_pos++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_H | BPF_ABS, offset);
+        *_pos++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, MAC_HI(macs[i]),
+                                               (count - 1 - i) * 4 + 1, 0);
+    }
+    *_pos++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+    return _pos - code;
+}
+
+/*
+ * Let the kernel drop what we are not going to handle: frames not sent to us
+ * or the group addresses, frames not from the server once it is known,
+ * and everything other than EAP Request/Success/Failure (Starts and Responses
+ * of other supplicants on the segment).
+ */
+static RESULT sockraw_update_filter(struct _if_impl* this) {
+    struct sock_filter _code[FILTER_MAX_LEN];
+    struct sock_filter* _pos = _code;
+    struct sock_fprog _prog;
+    uint8_t _local_mac[6] = {0};
+    const uint8_t* _dst_macs[] = {_local_mac, PAE_GROUP_ADDR, RJ_GROUP_ADDR, ETH_BCAST_ADDR};
+    const uint8_t* _src_macs[] = {PRIV->peer_mac};
+
+    if (IS_FAIL(obtain_iface_mac(PRIV->ifname, _local_mac))) {
+        return FAILURE;
+    }
+
+    _pos += sockraw_filter_match_mac(_pos, offsetof(ETHERNET_HEADER, dest_mac), _dst_macs, 4);
+    if (PRIV->has_peer_mac) {
+        _pos += sockraw_filter_match_mac(_pos, offsetof(ETHERNET_HEADER, src_mac), _src_macs, 1);
+    }
+    *_pos++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_B | BPF_ABS, offsetof(FRAME_HEADER, eapol_hdr.type));
+    *_pos++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, EAP_PACKET, 0, 3);
+    *_pos++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_B | BPF_ABS, offsetof(FRAME_HEADER, eap_hdr.code));
+    *_pos++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, EAP_RESPONSE, 1, 0);
+    *_pos++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0xffffffff);
+    *_pos++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+
+    _prog.len = _pos - _code;
+    _prog.filter = _code;
+    if (setsockopt(PRIV->sockfd, SOL_SOCKET, SO_ATTACH_FILTER, &_prog, sizeof(_prog)) < 0) {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Memberships are counted by the kernel and dropped when the socket is closed,
+ * so other users of the interface are not affected, unlike setting IFF_PROMISC.
+ */
+static RESULT sockraw_add_membership(struct _if_impl* this, int type, const uint8_t* addr) {
+    struct packet_mreq _mreq;
+
+    memset(&_mreq, 0, sizeof(_mreq));
+    _mreq.mr_ifindex = PRIV->if_index;
+    _mreq.mr_type = type;
+    if (addr != NULL) {
+        _mreq.mr_alen = ETH_ALEN;
+        memmove(_mreq.mr_address, addr, ETH_ALEN);
+    }
+    if (setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &_mreq, sizeof(_mreq)) < 0) {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/* Point the mmsg headers to their buffers, these never move */
+static void sockraw_setup_mmsg(struct _if_impl* this) {
+    int i;
+
+    memset(&PRIV->rx_mmsg.msgs, 0, sizeof(PRIV->rx_mmsg.msgs));
+    memset(&PRIV->tx_mmsg.msgs, 0, sizeof(PRIV->tx_mmsg.msgs));
+    for (i = 0; i < MMSG_BATCH; ++i) {
+        PRIV->rx_mmsg.iovs[i].iov_base = PRIV->rx_mmsg.bufs[i];
+        PRIV->rx_mmsg.iovs[i].iov_len = FRAME_BUF_SIZE;
+        PRIV->rx_mmsg.msgs[i].msg_hdr.msg_iov = &PRIV->rx_mmsg.iovs[i];
+        PRIV->rx_mmsg.msgs[i].msg_hdr.msg_iovlen = 1;
+        PRIV->rx_mmsg.msgs[i].msg_hdr.msg_control = PRIV->rx_mmsg.cmsgs[i];
+
+        /* Sent through the bound interface, no address needed */
+        PRIV->tx_mmsg.iovs[i].iov_base = PRIV->tx_mmsg.bufs[i];
+        PRIV->tx_mmsg.msgs[i].msg_hdr.msg_iov = &PRIV->tx_mmsg.iovs[i];
+        PRIV->tx_mmsg.msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    PRIV->tx_mmsg.pending = 0;
+}
+
 RESULT sockraw_prepare_interface(struct _if_impl* this) {
-    struct ifreq ifreq;
+    int _on = 1;
 
     if ((PRIV->sockfd = socket(AF_PACKET, SOCK_RAW, htons(PRIV->proto))) < 0) {
         PR_ERRNO("套接字打开失败");
         return FAILURE;
     }
-    sockraw_bind_to_if(this, PRIV->proto);
 
-    /* Handle promisc */
-    memset(&ifreq, 0, sizeof(struct ifreq));
-    strncpy(ifreq.ifr_name, PRIV->ifname, IFNAMSIZ);
+    /* Before binding, or frames in between would be stuck in the socket queue */
+    sockraw_setup_rings(this);
+    sockraw_setup_mmsg(this);
+    if (IS_FAIL(sockraw_update_filter(this))) {
+        PR_DBG("无法设置内核过滤器，将接收所有 EAPOL 帧: %s", strerror(errno));
+    }
+    sockraw_bind_to_if(this, PRIV->proto);
 
-    if (ioctl(PRIV->sockfd, SIOCGIFFLAGS, &ifreq) < 0) {
-        PR_ERRNO("获取网络界面标志信息失败");
-        return FAILURE;
+    /* Kernel receive timestamps for RTT measurement. Not fatal if unsupported */
+    if (setsockopt(PRIV->sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &_on, sizeof(_on)) < 0) {
+        PR_WARN("无法启用内核接收时间戳，超时估计将略有偏差");
     }
 
-    if (PRIV->promisc)
-        ifreq.ifr_flags |= IFF_PROMISC;
-    else
-        ifreq.ifr_flags &= ~IFF_PROMISC;
+    /* Frames to the group addresses are all we need, no promisc for them */
+    if (IS_FAIL(sockraw_add_membership(this, PACKET_MR_MULTICAST, PAE_GROUP_ADDR))
+            || IS_FAIL(sockraw_add_membership(this, PACKET_MR_MULTICAST, RJ_GROUP_ADDR))) {
+        PR_WARN("无法加入 802.1X 组播地址: %s", strerror(errno));
+    }
 
-    if (ioctl(PRIV->sockfd, SIOCSIFFLAGS, &ifreq) < 0) {
+    if (PRIV->promisc && IS_FAIL(sockraw_add_membership(this, PACKET_MR_PROMISC, NULL))) {
         PR_ERRNO("混杂模式设置失败");
         return FAILURE;
     }
     return SUCCESS;
 }
 
-RESULT sockraw_start_capture(struct _if_impl* this) {
-    uint8_t buf[FRAME_BUF_SIZE]; /* Max length of ethernet packet */
-    int recvlen = 0;
+/*
+ * Kernel receive timestamp from SO_TIMESTAMPNS, mapped to CLOCK_MONOTONIC.
+ * It does not include the time the frame spent in socket queue
+ * and event loop, which is good for RTT measurement.
+ */
+static uint64_t sockraw_get_recv_usecs(struct msghdr* msg) {
+    struct cmsghdr* cmsg;
+    struct timespec* ts;
+
+    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            ts = (struct timespec*)CMSG_DATA(cmsg);
+            return realtime_to_monotonic_usecs((uint64_t)ts->tv_sec * 1000000 + ts->tv_nsec / 1000);
+        }
+    }
+    return get_monotonic_usecs(); /* Not as accurate, but better than nothing */
+}
+
+/*
+ * Called by the event loop when the socket is readable.
+ * Drain the socket since there may be more than one frame queued,
+ * up to MMSG_BATCH of them per syscall.
+ */
+static void sockraw_on_readable(int fd, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    ETH_EAP_FRAME frame;
+    struct msghdr* _msg;
+    int _count, i;
+
+    do {
+        for (i = 0; i < MMSG_BATCH; ++i) {
+            PRIV->rx_mmsg.msgs[i].msg_hdr.msg_controllen = sizeof(PRIV->rx_mmsg.cmsgs[i]);
+        }
+        if ((_count = recvmmsg(fd, PRIV->rx_mmsg.msgs, MMSG_BATCH, MSG_DONTWAIT, NULL)) <= 0) {
+            break;
+        }
+
+        for (i = 0; i < _count; ++i) {
+            _msg = &PRIV->rx_mmsg.msgs[i].msg_hdr;
+            frame.content = PRIV->rx_mmsg.bufs[i];
+            frame.actual_len = PRIV->rx_mmsg.msgs[i].msg_len;
+            frame.buffer_len = FRAME_BUF_SIZE;
+            frame.recv_usecs = sockraw_get_recv_usecs(_msg);
+            if (frame.actual_len < sizeof(FRAME_HEADER)) {
+                /* Headers are read without checking the length */
+                memset(frame.content + frame.actual_len, 0, sizeof(FRAME_HEADER) - frame.actual_len);
+            }
+            PRIV->handler(&frame);
+        }
+    } while (_count == MMSG_BATCH);
+
+    if (_count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        PR_ERRNO("recvmmsg 调用失败");
+    }
+}
+
+/*
+ * Read and clear the pending error of the socket (e.g. ENETDOWN when the link
+ * goes down). It would be returned by some later call, and with the ring,
+ * where nothing reads the socket, keep waking up the event loop.
+ */
+static void sockraw_clear_error(struct _if_impl* this) {
+    int _err = 0;
+    socklen_t _len = sizeof(_err);
+
+    if (getsockopt(PRIV->sockfd, SOL_SOCKET, SO_ERROR, &_err, &_len) == 0 && _err != 0) {
+        PR_WARN("套接字出现错误: %s", strerror(_err));
+    }
+}
+
+/*
+ * Called by the event loop when a block in the ring is handed over,
+ * or the socket has an error (EPOLLERR).
+ * Frames are passed to the handler right in the ring, which gets them back
+ * once the handler returns.
+ */
+static void sockraw_on_ring_readable(int fd, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    struct tpacket_block_desc* _block;
+    struct tpacket3_hdr* _hdr;
+    uint8_t _short_buf[sizeof(FRAME_HEADER)];
     ETH_EAP_FRAME frame;
+    uint32_t i;
+    int _blocks = 0;
+
+    for (;; ++_blocks) {
+        _block = (struct tpacket_block_desc*)(PRIV->rx_ring + PRIV->rx_block * RX_RING_BLOCK_SIZE);
+        if (!(__atomic_load_n(&_block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            break;
+        }
+
+        _hdr = (struct tpacket3_hdr*)((uint8_t*)_block + _block->hdr.bh1.offset_to_first_pkt);
+        for (i = 0; i < _block->hdr.bh1.num_pkts; ++i) {
+            frame.content = (uint8_t*)_hdr + _hdr->tp_mac;
+            frame.actual_len = _hdr->tp_snaplen;
+            frame.buffer_len = _hdr->tp_snaplen; /* Nothing to append here */
+            frame.recv_usecs = realtime_to_monotonic_usecs(
+                                    (uint64_t)_hdr->tp_sec * 1000000 + _hdr->tp_nsec / 1000);
+            if (frame.actual_len < sizeof(_short_buf)) {
+                /* Headers are read without checking the length, give them zeros as before */
+                memset(_short_buf, 0, sizeof(_short_buf));
+                memmove(_short_buf, frame.content, frame.actual_len);
+                frame.content = _short_buf;
+            }
+            PRIV->handler(&frame);
+            _hdr = (struct tpacket3_hdr*)((uint8_t*)_hdr + _hdr->tp_next_offset);
+        }
+
+        __atomic_store_n(&_block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        PRIV->rx_block = (PRIV->rx_block + 1) % RX_RING_BLOCK_NR;
+    }
+
+    if (_blocks == 0) {
+        /* Woken up for nothing but an error */
+        sockraw_clear_error(this);
+    }
+}
+
+/*
+ * Send all frames queued in the sendmmsg() queue, a frame that fails is dropped
+ *
+ * Return: FAILURE if any frame is not sent
+ */
+static RESULT sockraw_flush_tx_mmsg(struct _if_impl* this) {
+    int _sent = 0, _ret;
+    RESULT _result = SUCCESS;
+
+    while (_sent < PRIV->tx_mmsg.pending) {
+        _ret = sendmmsg(PRIV->sockfd, PRIV->tx_mmsg.msgs + _sent, PRIV->tx_mmsg.pending - _sent, 0);
+        if (_ret < 0) {
+            PR_ERRNO("sendmmsg 调用失败");
+            _result = FAILURE;
+            _ret = 1;
+        }
+        _sent += _ret;
+    }
+    PRIV->tx_mmsg.pending = 0;
+    return _result;
+}
+
+/*
+ * Send all queued frames with one syscall.
+ * Frames the kernel refused are dropped, the state machine will retransmit.
+ *
+ * Return: FAILURE if any frame is not sent
+ */
+static RESULT sockraw_flush_tx_now(struct _if_impl* this) {
+    struct tpacket3_hdr* _hdr;
+    int i, _failed;
+    RESULT _result = SUCCESS;
+
+    if (PRIV->tx_ring == NULL) {
+        return sockraw_flush_tx_mmsg(this);
+    }
+    if (PRIV->tx_pending == 0) {
+        return SUCCESS;
+    }
+
+    _failed = send(PRIV->sockfd, NULL, 0, 0) < 0;
+    if (_failed) {
+        PR_ERRNO("send 调用失败");
+        _result = FAILURE;
+    }
+
+    for (i = 1; i <= PRIV->tx_pending; ++i) {
+        _hdr = TX_RING_SLOT((PRIV->tx_frame - i + TX_RING_FRAME_NR) % TX_RING_FRAME_NR);
+        if (_hdr->tp_status & TP_STATUS_WRONG_FORMAT) {
+            PR_ERR("内核拒绝发送长度为 %u 的帧", _hdr->tp_len);
+            __atomic_store_n(&_hdr->tp_status, TP_STATUS_AVAILABLE, __ATOMIC_RELEASE);
+            _result = FAILURE;
+        } else if (_failed && _hdr->tp_status == TP_STATUS_SEND_REQUEST) {
+            /* Do not let it go out with some later frame */
+            __atomic_store_n(&_hdr->tp_status, TP_STATUS_AVAILABLE, __ATOMIC_RELEASE);
+        }
+    }
+    PRIV->tx_pending = 0;
+
+    if (IS_FAIL(_result)) {
+        sockraw_clear_error(this);
+    }
+    return _result;
+}
+
+/* For the event loop. Errors are logged, the state machine will retransmit */
+static void sockraw_flush_tx(void* vthis) {
+    sockraw_flush_tx_now((IF_IMPL*)vthis);
+}
+
+/*
+ * Return: FAILURE if there is no free slot even after a flush,
+ *         which waits for the kernel to send what is in the ring
+ */
+static RESULT sockraw_queue_tx(struct _if_impl* this, ETH_EAP_FRAME* frame) {
+    struct tpacket3_hdr* _hdr = TX_RING_SLOT(PRIV->tx_frame);
+
+    if (__atomic_load_n(&_hdr->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+        sockraw_flush_tx_now(this);
+        if (__atomic_load_n(&_hdr->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+            return FAILURE; /* Still being sent by the kernel */
+        }
+    }
+
+    memmove((uint8_t*)_hdr + TX_RING_DATA_OFFSET, frame->content, frame->actual_len);
+    _hdr->tp_len = frame->actual_len;
+    _hdr->tp_next_offset = 0;
+    __atomic_store_n(&_hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+
+    PRIV->tx_frame = (PRIV->tx_frame + 1) % TX_RING_FRAME_NR;
+    PRIV->tx_pending++;
+    return SUCCESS;
+}
 
-    memset(buf, 0, FRAME_BUF_SIZE);
-    frame.actual_len = 0;
-    frame.buffer_len = FRAME_BUF_SIZE;
-    frame.content = buf;
-    // TODO will ctrl-c break recv first or call signal handler first?
-    while ((recvlen = recv(PRIV->sockfd, (void*)buf, 1512, 0)) > 0
-                && PRIV->stop_flag == 0) {
-        frame.actual_len = recvlen;
-        PRIV->handler(&frame);
-        memset(buf, 0, 1512);
+RESULT sockraw_start_capture(struct _if_impl* this) {
+    if (IS_FAIL(event_loop_add_fd(PRIV->sockfd,
+                                  PRIV->rx_ring ? sockraw_on_ring_readable : sockraw_on_readable, this))) {
+        return FAILURE;
     }
 
-    PRIV->stop_flag = 0;
-    return SUCCESS; /* No use if it's blocking... */
+    /* Timers and signals are handled in the same loop */
+    sockraw_flush_tx(this);
+    PRIV->tx_batch = TRUE;
+    event_loop_set_flush_func(sockraw_flush_tx, this);
+
+    RESULT ret = event_loop_run();
+
+    event_loop_set_flush_func(NULL, NULL);
+    PRIV->tx_batch = FALSE;
+    sockraw_flush_tx(this);
+    event_loop_remove_fd(PRIV->sockfd);
+    return ret;
 }
 
 RESULT sockraw_stop_capture(struct _if_impl* this) {
-    PRIV->stop_flag = 1;
+    event_loop_stop();
     return SUCCESS;
 }
 
 RESULT sockraw_send_frame(struct _if_impl* this, ETH_EAP_FRAME* frame) {
     struct sockaddr_ll socket_address;
+    int i;
     if (frame == NULL || frame->content == NULL)
         return FAILURE;
 
+    if (PRIV->tx_ring != NULL) {
+        /*
+         * Once the ring is mapped, every send() on the socket only sends what is
+         * in the ring, the buffer passed is ignored. No way around it.
+         */
+        if (frame->actual_len > TX_RING_FRAME_SIZE - TX_RING_DATA_OFFSET) {
+            PR_ERR("帧长度 %d 超出发送环的容量", (int)frame->actual_len);
+            return FAILURE;
+        }
+        if (IS_FAIL(sockraw_queue_tx(this, frame))) {
+            PR_ERR("发送环已满");
+            return FAILURE;
+        }
+        /* Nobody is going to flush it for us without the event loop */
+        return PRIV->tx_batch ? SUCCESS : sockraw_flush_tx_now(this);
+    }
+
+    if (frame->actual_len <= FRAME_BUF_SIZE) {
+        if (PRIV->tx_mmsg.pending == MMSG_BATCH) {
+            sockraw_flush_tx_now(this);
+        }
+        i = PRIV->tx_mmsg.pending++;
+        memmove(PRIV->tx_mmsg.bufs[i], frame->content, frame->actual_len);
+        PRIV->tx_mmsg.iovs[i].iov_len = frame->actual_len;
+        return PRIV->tx_batch ? SUCCESS : sockraw_flush_tx_now(this);
+    }
+    /* Too long to be batched, send what is queued first to keep the order */
+    sockraw_flush_tx_now(this);
+
     /* Send via this interface */
     memset(&socket_address, 0, sizeof(struct sockaddr_ll));
     socket_address.sll_ifindex = PRIV->if_index;
@@ -154,7 +619,21 @@ void sockraw_set_frame_handler(struct _if_impl* this, void (*handler)(ETH_EAP_FR
     PRIV->handler = handler;
 }
 
+void sockraw_set_peer_mac(struct _if_impl* this, const uint8_t* mac) {
+    PRIV->has_peer_mac = (mac != NULL);
+    if (mac != NULL) {
+        memmove(PRIV->peer_mac, mac, sizeof(PRIV->peer_mac));
+    }
+    if (PRIV->sockfd > 0 && IS_FAIL(sockraw_update_filter(this))) {
+        PR_DBG("无法更新内核过滤器: %s", strerror(errno));
+    }
+}
+
 void sockraw_destroy(IF_IMPL* this) {
+    if (PRIV->sockfd > 0)
+        sockraw_flush_tx_now(this);
+    if (PRIV->ring != NULL)
+        munmap(PRIV->ring, PRIV->ring_size);
     if (PRIV->sockfd > 0)
         close(PRIV->sockfd);
     chk_free((void**)&this->priv);
@@ -187,6 +666,7 @@ IF_IMPL* sockraw_new() {
     this->stop_capture = sockraw_stop_capture;
     this->send_frame = sockraw_send_frame;
     this->set_frame_handler = sockraw_set_frame_handler;
+    this->set_peer_mac = sockraw_set_peer_mac;
     this->name = "sockraw";
     this->description = "采用RAW Socket进行通信的轻量网络接口模块";
     return this;
@@ -0,0 +1,674 @@
+/*
+ * Implement packet sending/receiving by io_uring on a packet socket.
+ *
+ * Frames are received by one multishot recvmsg into a ring of provided buffers,
+ * sent by sendmsg, and alarms are timeouts in the same ring. Everything queued
+ * while handling a wakeup is submitted by the io_uring_enter() that waits for
+ * the next one, so sending, receiving and timers cost one syscall per wakeup.
+ * Packet plugins may still make their own: RJv3 reads the netlink and inotify fds
+ * of the interface and DNS caches (nonblocking) before every response.
+ * The other fds of the event loop are watched by polling the epoll fd in the ring.
+ *
+ * Needs Linux 6.0+ for multishot recvmsg. No liburing needed.
+ */
+#include "if_impl.h"
+#include "minieap_common.h"
+#include "logging.h"
+#include "misc.h"
+#include "event_loop.h"
+#include "sched_alarm.h"
+
+#include <netinet/in.h>
+#include <linux/if_ether.h> // ETH_ALEN
+#include <linux/if_packet.h>
+#include <linux/io_uring.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#define URING_QUEUE_DEPTH 32
+
+/* Provided buffers for receiving, each one holds the recvmsg header, cmsgs and a frame */
+#define URING_BUF_NR 16 /* Power of 2 */
+#define URING_BUF_GROUP 0
+#define URING_CMSG_SIZE CMSG_SPACE(sizeof(struct timespec))
+#define URING_BUF_SIZE (sizeof(struct io_uring_recvmsg_out) + URING_CMSG_SIZE + FRAME_BUF_SIZE)
+
+/* Sends in flight, their buffers must live until completion */
+#define URING_TX_SLOTS 8
+
+/* user_data of requests: the kind in low 8 bits, slot or generation above */
+#define URING_REQ_RECV 1
+#define URING_REQ_EPOLL 2
+#define URING_REQ_TIMEOUT 3
+#define URING_REQ_TIMEOUT_REMOVE 4
+#define URING_REQ_SEND 5
+#define URING_USER_DATA(req, arg) ((req) | ((uint64_t)(arg) << 8))
+
+static const uint8_t PAE_GROUP_ADDR[6] = {0x01,0x80,0xc2,0x00,0x00,0x03};
+static const uint8_t RJ_GROUP_ADDR[6] = {0x01,0xd0,0xf8,0x00,0x00,0x03};
+
+typedef struct _if_impl_uring_priv {
+    char ifname[IFNAMSIZ];
+    int sockfd;
+    int if_index;
+    int promisc;
+    short proto; /* Stored as host byte order */
+    void (*handler)(ETH_EAP_FRAME* frame);
+    int ring_fd;
+    void* ring_map; /* SQ and CQ rings in one mapping */
+    size_t ring_map_len;
+    struct {
+        uint32_t* head;
+        uint32_t* tail;
+        uint32_t* array;
+        uint32_t mask;
+        uint32_t entries;
+        uint32_t local_tail; /* Published to the kernel on submission */
+        struct io_uring_sqe* sqes;
+        size_t sqes_len;
+    } sq;
+    struct {
+        uint32_t* head;
+        uint32_t* tail;
+        uint32_t mask;
+        struct io_uring_cqe* cqes;
+    } cq;
+    struct io_uring_buf_ring* buf_ring;
+    size_t buf_ring_len;
+    uint16_t buf_tail;
+    uint8_t bufs[URING_BUF_NR][URING_BUF_SIZE];
+    struct msghdr recv_msg; /* Only the lengths matter for multishot recvmsg */
+    int recv_armed;
+    int epoll_armed;
+    struct {
+        struct msghdr msg;
+        struct iovec iov;
+        uint8_t buf[FRAME_BUF_SIZE];
+        int busy;
+    } tx[URING_TX_SLOTS];
+    int tx_batch; /* Submitted when waiting, not after each frame */
+    int tx_inflight; /* Sends whose CQE is not reaped yet */
+    struct __kernel_timespec timeout_ts;
+    uint64_t timeout_deadline; /* ms, 0 = no timeout in the ring */
+    uint64_t timeout_wanted; /* Nearest deadline of sched_alarm */
+    uint32_t timeout_gen; /* Tells the current timeout from removed ones */
+} uring_priv;
+
+#define PRIV ((uring_priv*)(this->priv))
+
+RESULT uring_set_ifname(struct _if_impl* this, const char* ifname) {
+    struct ifreq ifreq;
+    int _tmpsockfd = 0;
+
+    if ((_tmpsockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+        PR_ERRNO("套接字打开失败");
+        return FAILURE;
+    }
+
+    memset(&ifreq, 0, sizeof(struct ifreq));
+    strncpy(ifreq.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(_tmpsockfd, SIOCGIFINDEX, &ifreq) < 0) {
+        PR_ERRNO("网络界面 ID 获取失败");
+        close(_tmpsockfd);
+        return FAILURE;
+    }
+    PRIV->if_index = ifreq.ifr_ifindex;
+
+    strncpy(PRIV->ifname, ifname, IFNAMSIZ - 1);
+    close(_tmpsockfd);
+    return SUCCESS;
+}
+
+RESULT uring_get_ifname(struct _if_impl* this, char* buf, int buflen) {
+    if (buflen < strnlen(PRIV->ifname, IFNAMSIZ)) {
+        return FAILURE;
+    }
+    strncpy(buf, PRIV->ifname, IFNAMSIZ);
+    return SUCCESS;
+}
+
+RESULT uring_setup_capture_params(struct _if_impl* this, unsigned short eth_protocol, int promisc) {
+    PRIV->proto = eth_protocol;
+    PRIV->promisc = promisc;
+    return SUCCESS;
+}
+
+static void uring_recycle_buf(struct _if_impl* this, uint16_t bid) {
+    struct io_uring_buf* _buf = &PRIV->buf_ring->bufs[PRIV->buf_tail & (URING_BUF_NR - 1)];
+
+    _buf->addr = (uint64_t)(unsigned long)PRIV->bufs[bid];
+    _buf->len = URING_BUF_SIZE;
+    _buf->bid = bid;
+    PRIV->buf_tail++;
+    __atomic_store_n(&PRIV->buf_ring->tail, PRIV->buf_tail, __ATOMIC_RELEASE);
+}
+
+/*
+ * Create the ring, map SQ/CQ and register the provided buffers.
+ * Deferred task running (Linux 6.1+) keeps completions from interrupting us,
+ * they are only processed when we wait anyway.
+ */
+static RESULT uring_setup_ring(struct _if_impl* this) {
+    struct io_uring_params _params;
+    struct io_uring_buf_reg _reg;
+    size_t _sq_len, _cq_len;
+    int i;
+
+    memset(&_params, 0, sizeof(_params));
+    _params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    if ((PRIV->ring_fd = syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &_params)) < 0 && errno == EINVAL) {
+        memset(&_params, 0, sizeof(_params));
+        PRIV->ring_fd = syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &_params);
+    }
+    if (PRIV->ring_fd < 0) {
+        PR_ERRNO("io_uring 创建失败");
+        return FAILURE;
+    }
+    if (!(_params.features & IORING_FEAT_SINGLE_MMAP)) {
+        PR_ERR("内核版本过低，无法使用 io_uring 模块");
+        return FAILURE;
+    }
+
+    _sq_len = _params.sq_off.array + _params.sq_entries * sizeof(uint32_t);
+    _cq_len = _params.cq_off.cqes + _params.cq_entries * sizeof(struct io_uring_cqe);
+    PRIV->ring_map_len = _sq_len > _cq_len ? _sq_len : _cq_len;
+    PRIV->ring_map = mmap(NULL, PRIV->ring_map_len, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, PRIV->ring_fd, IORING_OFF_SQ_RING);
+    if (PRIV->ring_map == MAP_FAILED) {
+        PRIV->ring_map = NULL;
+        PR_ERRNO("io_uring 环映射失败");
+        return FAILURE;
+    }
+    PRIV->sq.sqes_len = _params.sq_entries * sizeof(struct io_uring_sqe);
+    PRIV->sq.sqes = mmap(NULL, PRIV->sq.sqes_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, PRIV->ring_fd, IORING_OFF_SQES);
+    if (PRIV->sq.sqes == MAP_FAILED) {
+        PRIV->sq.sqes = NULL;
+        PR_ERRNO("io_uring 环映射失败");
+        return FAILURE;
+    }
+
+#define RING_FIELD(off) ((uint32_t*)((uint8_t*)PRIV->ring_map + (off)))
+    PRIV->sq.head = RING_FIELD(_params.sq_off.head);
+    PRIV->sq.tail = RING_FIELD(_params.sq_off.tail);
+    PRIV->sq.array = RING_FIELD(_params.sq_off.array);
+    PRIV->sq.mask = *RING_FIELD(_params.sq_off.ring_mask);
+    PRIV->sq.entries = _params.sq_entries;
+    PRIV->sq.local_tail = *PRIV->sq.tail;
+    PRIV->cq.head = RING_FIELD(_params.cq_off.head);
+    PRIV->cq.tail = RING_FIELD(_params.cq_off.tail);
+    PRIV->cq.mask = *RING_FIELD(_params.cq_off.ring_mask);
+    PRIV->cq.cqes = (struct io_uring_cqe*)((uint8_t*)PRIV->ring_map + _params.cq_off.cqes);
+#undef RING_FIELD
+
+    /* Page aligned as required */
+    PRIV->buf_ring_len = URING_BUF_NR * sizeof(struct io_uring_buf);
+    PRIV->buf_ring = mmap(NULL, PRIV->buf_ring_len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (PRIV->buf_ring == MAP_FAILED) {
+        PRIV->buf_ring = NULL;
+        PR_ERRNO("io_uring 缓冲区分配失败");
+        return FAILURE;
+    }
+    memset(&_reg, 0, sizeof(_reg));
+    _reg.ring_addr = (uint64_t)(unsigned long)PRIV->buf_ring;
+    _reg.ring_entries = URING_BUF_NR;
+    _reg.bgid = URING_BUF_GROUP;
+    if (syscall(__NR_io_uring_register, PRIV->ring_fd, IORING_REGISTER_PBUF_RING, &_reg, 1) < 0) {
+        PR_ERRNO("io_uring 缓冲区注册失败");
+        return FAILURE;
+    }
+    for (i = 0; i < URING_BUF_NR; ++i) {
+        uring_recycle_buf(this, i);
+    }
+    return SUCCESS;
+}
+
+/*
+ * Submit everything queued, and wait for `min_complete` completions if it's not 0
+ *
+ * Return: same as io_uring_enter()
+ */
+static int uring_enter(struct _if_impl* this, unsigned int min_complete) {
+    uint32_t _to_submit;
+
+    __atomic_store_n(PRIV->sq.tail, PRIV->sq.local_tail, __ATOMIC_RELEASE);
+    _to_submit = PRIV->sq.local_tail - __atomic_load_n(PRIV->sq.head, __ATOMIC_ACQUIRE);
+    if (_to_submit == 0 && min_complete == 0) {
+        return 0;
+    }
+    return syscall(__NR_io_uring_enter, PRIV->ring_fd, _to_submit, min_complete,
+                   min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+/*
+ * A cleared SQE at the tail. It is not seen by the kernel until the next `uring_enter`.
+ *
+ * Return: NULL if SQ is full even after submitting
+ */
+static struct io_uring_sqe* uring_get_sqe(struct _if_impl* this, uint64_t user_data) {
+    struct io_uring_sqe* _sqe;
+    uint32_t _index;
+
+    if (PRIV->sq.local_tail - __atomic_load_n(PRIV->sq.head, __ATOMIC_ACQUIRE) == PRIV->sq.entries) {
+        uring_enter(this, 0);
+        if (PRIV->sq.local_tail - __atomic_load_n(PRIV->sq.head, __ATOMIC_ACQUIRE) == PRIV->sq.entries) {
+            PR_ERR("io_uring 提交队列已满");
+            return NULL;
+        }
+    }
+
+    _index = PRIV->sq.local_tail++ & PRIV->sq.mask;
+    _sqe = &PRIV->sq.sqes[_index];
+    memset(_sqe, 0, sizeof(*_sqe));
+    _sqe->user_data = user_data;
+    PRIV->sq.array[_index] = _index;
+    return _sqe;
+}
+
+RESULT uring_prepare_interface(struct _if_impl* this) {
+    struct sockaddr_ll _sll;
+    struct packet_mreq _mreq;
+    int _on = 1;
+    int i;
+
+    if ((PRIV->sockfd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(PRIV->proto))) < 0) {
+        PR_ERRNO("套接字打开失败");
+        return FAILURE;
+    }
+
+    memset(&_sll, 0, sizeof(_sll));
+    _sll.sll_family = AF_PACKET;
+    _sll.sll_ifindex = PRIV->if_index;
+    _sll.sll_protocol = htons(PRIV->proto);
+    if (bind(PRIV->sockfd, (struct sockaddr*)&_sll, sizeof(_sll)) < 0) {
+        PR_ERRNO("套接字绑定失败");
+        return FAILURE;
+    }
+
+    /* Kernel receive timestamps for RTT measurement. Not fatal if unsupported */
+    if (setsockopt(PRIV->sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &_on, sizeof(_on)) < 0) {
+        PR_WARN("无法启用内核接收时间戳，超时估计将略有偏差");
+    }
+
+    /* Same as sockraw, memberships go away with the socket */
+    memset(&_mreq, 0, sizeof(_mreq));
+    _mreq.mr_ifindex = PRIV->if_index;
+    _mreq.mr_type = PACKET_MR_MULTICAST;
+    _mreq.mr_alen = ETH_ALEN;
+    memmove(_mreq.mr_address, PAE_GROUP_ADDR, ETH_ALEN);
+    if (setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &_mreq, sizeof(_mreq)) < 0) {
+        PR_WARN("无法加入 802.1X 组播地址: %s", strerror(errno));
+    }
+    memmove(_mreq.mr_address, RJ_GROUP_ADDR, ETH_ALEN);
+    if (setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &_mreq, sizeof(_mreq)) < 0) {
+        PR_WARN("无法加入 802.1X 组播地址: %s", strerror(errno));
+    }
+    if (PRIV->promisc) {
+        memset(&_mreq, 0, sizeof(_mreq));
+        _mreq.mr_ifindex = PRIV->if_index;
+        _mreq.mr_type = PACKET_MR_PROMISC;
+        if (setsockopt(PRIV->sockfd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &_mreq, sizeof(_mreq)) < 0) {
+            PR_ERRNO("混杂模式设置失败");
+            return FAILURE;
+        }
+    }
+
+    if (IS_FAIL(uring_setup_ring(this))) {
+        return FAILURE;
+    }
+
+    PRIV->recv_msg.msg_controllen = URING_CMSG_SIZE;
+    for (i = 0; i < URING_TX_SLOTS; ++i) {
+        /* Sent through the bound interface, no address needed */
+        PRIV->tx[i].iov.iov_base = PRIV->tx[i].buf;
+        PRIV->tx[i].msg.msg_iov = &PRIV->tx[i].iov;
+        PRIV->tx[i].msg.msg_iovlen = 1;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Kernel receive timestamp from SO_TIMESTAMPNS, mapped to CLOCK_MONOTONIC
+ */
+static uint64_t uring_get_recv_usecs(struct msghdr* msg) {
+    struct cmsghdr* cmsg;
+    struct timespec* ts;
+
+    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            ts = (struct timespec*)CMSG_DATA(cmsg);
+            return realtime_to_monotonic_usecs((uint64_t)ts->tv_sec * 1000000 + ts->tv_nsec / 1000);
+        }
+    }
+    return get_monotonic_usecs();
+}
+
+/*
+ * A frame in provided buffer `bid`, `len` bytes in total including the recvmsg header.
+ * The frame is handed to the handler in place, then the buffer goes back to the kernel.
+ */
+static void uring_on_frame(struct _if_impl* this, uint16_t bid, int len) {
+    uint8_t* _buf = PRIV->bufs[bid];
+    struct io_uring_recvmsg_out* _out = (struct io_uring_recvmsg_out*)_buf;
+    int _payload_offset = sizeof(*_out) + PRIV->recv_msg.msg_namelen + PRIV->recv_msg.msg_controllen;
+    struct msghdr _msg;
+    ETH_EAP_FRAME frame;
+
+    memset(&_msg, 0, sizeof(_msg));
+    _msg.msg_control = _buf + sizeof(*_out) + PRIV->recv_msg.msg_namelen;
+    _msg.msg_controllen = _out->controllen;
+
+    frame.content = _buf + _payload_offset;
+    frame.actual_len = len - _payload_offset;
+    frame.buffer_len = FRAME_BUF_SIZE;
+    frame.recv_usecs = uring_get_recv_usecs(&_msg);
+    if (frame.actual_len < sizeof(FRAME_HEADER)) {
+        /* Headers are read without checking the length */
+        memset(frame.content + frame.actual_len, 0, sizeof(FRAME_HEADER) - frame.actual_len);
+    }
+    PRIV->handler(&frame);
+    uring_recycle_buf(this, bid);
+}
+
+/*
+ * Called by sched_alarm when the nearest deadline may have changed.
+ * Alarms are often unscheduled and scheduled again in one callback, so only
+ * the last deadline is kept, and the ring follows it in `uring_sync_timer`.
+ */
+static void uring_set_timer(uint64_t deadline_ms, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    PRIV->timeout_wanted = deadline_ms;
+}
+
+/*
+ * Queue requests to make the timeout in the ring match the wanted deadline.
+ * A pending timeout is updated in place, which posts nothing unless it fails.
+ */
+static void uring_sync_timer(struct _if_impl* this) {
+    struct io_uring_sqe* _sqe;
+
+    if (PRIV->timeout_wanted == PRIV->timeout_deadline) {
+        return;
+    }
+
+    /* Copied by the kernel on submission */
+    PRIV->timeout_ts.tv_sec = PRIV->timeout_wanted / 1000;
+    PRIV->timeout_ts.tv_nsec = (PRIV->timeout_wanted % 1000) * 1000000;
+
+    if (PRIV->timeout_deadline) {
+        /* If it has fired already, the update fails and its CQE is ignored as stale */
+        if ((_sqe = uring_get_sqe(this, URING_USER_DATA(URING_REQ_TIMEOUT_REMOVE, 0))) == NULL) {
+            return;
+        }
+        _sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+        _sqe->fd = -1;
+        _sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+        _sqe->addr = URING_USER_DATA(URING_REQ_TIMEOUT, PRIV->timeout_gen);
+        if (PRIV->timeout_wanted) {
+            _sqe->addr2 = (uint64_t)(unsigned long)&PRIV->timeout_ts;
+            _sqe->timeout_flags = IORING_TIMEOUT_UPDATE | IORING_TIMEOUT_ABS;
+        } else {
+            PRIV->timeout_gen++;
+        }
+        PRIV->timeout_deadline = PRIV->timeout_wanted;
+        return;
+    }
+
+    if ((_sqe = uring_get_sqe(this, URING_USER_DATA(URING_REQ_TIMEOUT, PRIV->timeout_gen))) == NULL) {
+        return;
+    }
+    _sqe->opcode = IORING_OP_TIMEOUT;
+    _sqe->fd = -1;
+    _sqe->addr = (uint64_t)(unsigned long)&PRIV->timeout_ts;
+    _sqe->len = 1;
+    _sqe->timeout_flags = IORING_TIMEOUT_ABS; /* CLOCK_MONOTONIC */
+    PRIV->timeout_deadline = PRIV->timeout_wanted;
+}
+
+/*
+ * Whether a failed recv only needs to be re-armed: out of buffers (they are
+ * back by then), link down or interface gone for a while, or interrupted
+ */
+static int uring_recv_error_transient(int err) {
+    switch (err) {
+        case ENOBUFS:
+        case ENETDOWN:
+        case ENXIO:
+        case EINTR:
+        case EAGAIN:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+/*
+ * Handle all completions
+ *
+ * Return: 1 if the epoll fd is readable, 0 if not,
+ *         -1 if receiving failed for good
+ */
+static int uring_reap(struct _if_impl* this) {
+    struct io_uring_cqe* _cqe;
+    uint64_t _user_data;
+    uint32_t _head;
+    int _res, _flags;
+    int _ret = 0;
+
+    /* Head is read again each time, the handler may reap in send_frame */
+    while ((_head = *PRIV->cq.head) != __atomic_load_n(PRIV->cq.tail, __ATOMIC_ACQUIRE)) {
+        _cqe = &PRIV->cq.cqes[_head & PRIV->cq.mask];
+        _user_data = _cqe->user_data;
+        _res = _cqe->res;
+        _flags = _cqe->flags;
+        __atomic_store_n(PRIV->cq.head, _head + 1, __ATOMIC_RELEASE);
+
+        switch (_user_data & 0xff) {
+            case URING_REQ_RECV:
+                if (!(_flags & IORING_CQE_F_MORE)) {
+                    PRIV->recv_armed = FALSE;
+                }
+                if (_res >= 0 && (_flags & IORING_CQE_F_BUFFER)) {
+                    uring_on_frame(this, _flags >> IORING_CQE_BUFFER_SHIFT, _res);
+                } else if (_res < 0 && !uring_recv_error_transient(-_res)) {
+                    PR_ERR("recvmsg 调用失败: %s", strerror(-_res));
+                    errno = -_res;
+                    _ret = -1;
+                } else if (_res < 0 && _res != -ENOBUFS) {
+                    /* Errors end the multishot recv, uring_wait() arms a new one */
+                    PR_WARN("recvmsg 调用失败，将重新接收: %s", strerror(-_res));
+                }
+                break;
+            case URING_REQ_EPOLL:
+                PRIV->epoll_armed = FALSE;
+                if (_res > 0 && _ret == 0) {
+                    _ret = 1;
+                }
+                break;
+            case URING_REQ_TIMEOUT:
+                if (_res == -ETIME && (_user_data >> 8) == PRIV->timeout_gen) {
+                    PRIV->timeout_gen++;
+                    PRIV->timeout_deadline = 0;
+                    sched_alarm_ring();
+                }
+                break;
+            case URING_REQ_SEND:
+                PRIV->tx[_user_data >> 8].busy = FALSE;
+                PRIV->tx_inflight--;
+                if (_res < 0) {
+                    PR_ERR("sendmsg 调用失败: %s", strerror(-_res));
+                }
+                break;
+        }
+    }
+    return _ret;
+}
+
+/*
+ * Waits for the event loop: submit what was queued by the last callbacks,
+ * then sleep until frames, alarms or other fds of the loop wake us up
+ */
+static int uring_wait(int epfd, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    struct io_uring_sqe* _sqe;
+
+    /* One-shot, so events left in epoll by the last dispatch wake us up again */
+    if (!PRIV->epoll_armed && (_sqe = uring_get_sqe(this, URING_USER_DATA(URING_REQ_EPOLL, 0))) != NULL) {
+        _sqe->opcode = IORING_OP_POLL_ADD;
+        _sqe->fd = epfd;
+        _sqe->poll32_events = POLLIN;
+        PRIV->epoll_armed = TRUE;
+    }
+
+    if (!PRIV->recv_armed && (_sqe = uring_get_sqe(this, URING_USER_DATA(URING_REQ_RECV, 0))) != NULL) {
+        _sqe->opcode = IORING_OP_RECVMSG;
+        _sqe->fd = PRIV->sockfd;
+        _sqe->addr = (uint64_t)(unsigned long)&PRIV->recv_msg;
+        _sqe->len = 1;
+        _sqe->ioprio = IORING_RECV_MULTISHOT;
+        _sqe->flags = IOSQE_BUFFER_SELECT;
+        _sqe->buf_group = URING_BUF_GROUP;
+        PRIV->recv_armed = TRUE;
+    }
+
+    uring_sync_timer(this);
+
+    /*
+     * Sends post their CQEs right away, they should not count as a wakeup.
+     * Otherwise the frame or alarm they lead to would cost another enter.
+     */
+    if (uring_enter(this, 1 + PRIV->tx_inflight) < 0 && errno != EINTR) {
+        PR_ERRNO("io_uring_enter 调用失败");
+        return -1;
+    }
+    return uring_reap(this);
+}
+
+RESULT uring_start_capture(struct _if_impl* this) {
+    RESULT ret;
+
+    PRIV->tx_batch = TRUE;
+    event_loop_set_wait_func(uring_wait, this);
+    sched_alarm_set_timer_func(uring_set_timer, this);
+
+    ret = event_loop_run();
+
+    sched_alarm_set_timer_func(NULL, NULL);
+    event_loop_set_wait_func(NULL, NULL);
+    uring_set_timer(0, this);
+    uring_sync_timer(this);
+    PRIV->tx_batch = FALSE;
+    uring_enter(this, 0); /* What the last callbacks sent */
+    return ret;
+}
+
+RESULT uring_stop_capture(struct _if_impl* this) {
+    event_loop_stop();
+    return SUCCESS;
+}
+
+RESULT uring_send_frame(struct _if_impl* this, ETH_EAP_FRAME* frame) {
+    struct io_uring_sqe* _sqe;
+    int i;
+
+    if (frame == NULL || frame->content == NULL || frame->actual_len > FRAME_BUF_SIZE)
+        return FAILURE;
+
+    for (i = 0; i < URING_TX_SLOTS && PRIV->tx[i].busy; ++i);
+    if (i == URING_TX_SLOTS) {
+        /* At least one of them is going to complete */
+        if (uring_enter(this, 1) < 0) {
+            PR_ERRNO("io_uring_enter 调用失败");
+            return FAILURE;
+        }
+        uring_reap(this);
+        for (i = 0; i < URING_TX_SLOTS && PRIV->tx[i].busy; ++i);
+        if (i == URING_TX_SLOTS) {
+            PR_ERR("io_uring 发送队列已满");
+            return FAILURE;
+        }
+    }
+
+    if ((_sqe = uring_get_sqe(this, URING_USER_DATA(URING_REQ_SEND, i))) == NULL) {
+        return FAILURE;
+    }
+    memmove(PRIV->tx[i].buf, frame->content, frame->actual_len);
+    PRIV->tx[i].iov.iov_len = frame->actual_len;
+    PRIV->tx[i].busy = TRUE;
+    PRIV->tx_inflight++;
+    _sqe->opcode = IORING_OP_SENDMSG;
+    _sqe->fd = PRIV->sockfd;
+    _sqe->addr = (uint64_t)(unsigned long)&PRIV->tx[i].msg;
+    _sqe->len = 1;
+
+    if (!PRIV->tx_batch && uring_enter(this, 0) < 0) {
+        /* Nobody is going to submit it for us */
+        PR_ERRNO("io_uring_enter 调用失败");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+void uring_set_frame_handler(struct _if_impl* this, void (*handler)(ETH_EAP_FRAME* frame)) {
+    PRIV->handler = handler;
+}
+
+void uring_destroy(IF_IMPL* this) {
+    if (PRIV->ring_fd >= 0) {
+        /* Requests still in the ring are cancelled when it's closed */
+        if (PRIV->sq.sqes != NULL)
+            uring_enter(this, 0);
+        close(PRIV->ring_fd);
+    }
+    if (PRIV->buf_ring != NULL)
+        munmap(PRIV->buf_ring, PRIV->buf_ring_len);
+    if (PRIV->sq.sqes != NULL)
+        munmap(PRIV->sq.sqes, PRIV->sq.sqes_len);
+    if (PRIV->ring_map != NULL)
+        munmap(PRIV->ring_map, PRIV->ring_map_len);
+    if (PRIV->sockfd >= 0)
+        close(PRIV->sockfd);
+    chk_free((void**)&this->priv);
+    chk_free((void**)&this);
+}
+
+IF_IMPL* uring_new() {
+    IF_IMPL* this = (IF_IMPL*)malloc(sizeof(IF_IMPL));
+    if (this == NULL) {
+        PR_ERRNO("io_uring 主结构内存分配失败");
+        return NULL;
+    }
+    memset(this, 0, sizeof(IF_IMPL));
+
+    /* The priv pointer in if_impl.h is a uring_priv* here */
+    this->priv = (uring_priv*)malloc(sizeof(uring_priv));
+    if (this->priv == NULL) {
+        PR_ERRNO("io_uring 私有结构内存分配失败");
+        free(this);
+        return NULL;
+    }
+    memset(this->priv, 0, sizeof(uring_priv));
+    PRIV->sockfd = -1;
+    PRIV->ring_fd = -1;
+
+    this->set_ifname = uring_set_ifname;
+    this->get_ifname = uring_get_ifname;
+    this->destroy = uring_destroy;
+    this->setup_capture_params = uring_setup_capture_params;
+    this->prepare_interface = uring_prepare_interface;
+    this->start_capture = uring_start_capture;
+    this->stop_capture = uring_stop_capture;
+    this->send_frame = uring_send_frame;
+    this->set_frame_handler = uring_set_frame_handler;
+    this->name = "uring";
+    this->description = "采用 io_uring 进行通信的网络接口模块，收发帧与定时器共用一次系统调用";
+    return this;
+}
+IF_IMPL_INIT(uring_new)
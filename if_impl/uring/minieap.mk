@@ -0,0 +1,11 @@
+# Makefile for interface implementation: io_uring
+
+LOCAL_PATH := $(call my-dir)
+
+LOCAL_SRC_FILES := if_impl_uring.c
+LOCAL_C_INCLUDES :=
+LOCAL_CFLAGS :=
+LOCAL_LDFLAGS :=
+LOCAL_MODULE := if_impl_uring
+
+include $(APPEND)
@@ -0,0 +1,653 @@
+/*
+ * Implement packet sending/receiving by AF_XDP.
+ *
+ * A tiny XDP program redirects frames of our protocol into an AF_XDP socket,
+ * everything else goes on to the network stack untouched. Frames are received
+ * into and sent from a UMEM shared with the kernel.
+ *
+ * Native XDP is used if the driver supports it, generic (SKB) mode otherwise.
+ * Needs Linux 5.3+ for bpf_redirect_map() falling back to XDP_PASS.
+ * No libbpf needed, the program is loaded with bpf() directly.
+ *
+ * Only RX queue 0 is served. EAPOL has no IP header to spread by RSS,
+ * so it lands there on most NICs. Frames on other queues go to the stack.
+ */
+#include "if_impl.h"
+#include "minieap_common.h"
+#include "logging.h"
+#include "misc.h"
+#include "event_loop.h"
+#include "sched_alarm.h"
+
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+#include <linux/if_link.h>
+#include <linux/if_packet.h>
+#include <linux/if_xdp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+#define UMEM_FRAME_SIZE 2048
+#define UMEM_FRAME_NR 64 /* First half is for receiving, second half for sending */
+#define XSK_RING_SIZE (UMEM_FRAME_NR / 2)
+#define XSK_QUEUE_ID 0
+#define XSK_TX_RETRY_MS 2 /* Nothing wakes us up when the kernel is ready to send again */
+
+/* One ring shared with the kernel */
+typedef struct _xsk_ring {
+    uint32_t* producer;
+    uint32_t* consumer;
+    void* descs;
+    void* map;
+    size_t map_len;
+    uint32_t cached; /* Our side of producer/consumer */
+} XSK_RING;
+
+typedef struct _if_impl_xdp_priv {
+    char ifname[IFNAMSIZ];
+    int if_index;
+    int promisc;
+    unsigned short proto; /* Stored as host byte order */
+    void (*handler)(ETH_EAP_FRAME* frame);
+    int xsk_fd;
+    int map_fd; /* XSKMAP, queue id -> socket */
+    int prog_fd;
+    int link_fd; /* bpf_link, detaching when closed. -1 if attached by netlink */
+    uint32_t nl_xdp_flags; /* Mode attached by netlink, 0 = not attached */
+    int mreq_fd; /* AF_PACKET socket only holding group memberships */
+    uint8_t* umem;
+    XSK_RING rx, tx, fill, comp;
+    uint64_t tx_free[XSK_RING_SIZE]; /* UMEM frames available for sending */
+    int tx_free_count;
+    int tx_pending; /* Frames in TX ring since last kick */
+    int tx_retry_alarm; /* Kicking again after the kernel was busy, 0 = not scheduled */
+    int tx_batch; /* Kicked by the event loop, not after each frame */
+} xdp_priv;
+
+#define PRIV ((xdp_priv*)(this->priv))
+
+#define XSK_DESC(ring, type, idx) (((type*)(ring).descs)[(idx) & (XSK_RING_SIZE - 1)])
+
+static int sys_bpf(int cmd, union bpf_attr* attr) {
+    return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+RESULT xdp_set_ifname(struct _if_impl* this, const char* ifname) {
+    if ((PRIV->if_index = if_nametoindex(ifname)) == 0) {
+        PR_ERRNO("网络界面 ID 获取失败");
+        return FAILURE;
+    }
+    strncpy(PRIV->ifname, ifname, IFNAMSIZ - 1);
+    return SUCCESS;
+}
+
+RESULT xdp_get_ifname(struct _if_impl* this, char* buf, int buflen) {
+    if (buflen < strnlen(PRIV->ifname, IFNAMSIZ)) {
+        return FAILURE;
+    }
+    strncpy(buf, PRIV->ifname, IFNAMSIZ);
+    return SUCCESS;
+}
+
+RESULT xdp_setup_capture_params(struct _if_impl* this, unsigned short eth_protocol, int promisc) {
+    PRIV->proto = eth_protocol;
+    PRIV->promisc = promisc;
+    return SUCCESS;
+}
+
+/*
+ * XDP sockets can not join multicast groups themselves. Let an AF_PACKET socket
+ * that receives nothing hold the memberships, they go away when it's closed.
+ */
+static RESULT xdp_add_membership(struct _if_impl* this, int type, const uint8_t* addr) {
+    struct packet_mreq _mreq;
+
+    memset(&_mreq, 0, sizeof(_mreq));
+    _mreq.mr_ifindex = PRIV->if_index;
+    _mreq.mr_type = type;
+    if (addr != NULL) {
+        _mreq.mr_alen = ETH_ALEN;
+        memmove(_mreq.mr_address, addr, ETH_ALEN);
+    }
+    if (setsockopt(PRIV->mreq_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &_mreq, sizeof(_mreq)) < 0) {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static RESULT xdp_join_groups(struct _if_impl* this) {
+    static const uint8_t _pae_group[6] = {0x01,0x80,0xc2,0x00,0x00,0x03};
+    static const uint8_t _rj_group[6] = {0x01,0xd0,0xf8,0x00,0x00,0x03};
+
+    if ((PRIV->mreq_fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0)) < 0) {
+        PR_ERRNO("套接字打开失败");
+        return FAILURE;
+    }
+    if (IS_FAIL(xdp_add_membership(this, PACKET_MR_MULTICAST, _pae_group))
+            || IS_FAIL(xdp_add_membership(this, PACKET_MR_MULTICAST, _rj_group))) {
+        PR_WARN("无法加入 802.1X 组播地址: %s", strerror(errno));
+    }
+    if (PRIV->promisc && IS_FAIL(xdp_add_membership(this, PACKET_MR_PROMISC, NULL))) {
+        PR_ERRNO("混杂模式设置失败");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static RESULT xdp_map_ring(struct _if_impl* this, XSK_RING* ring, off_t pgoff,
+                           const struct xdp_ring_offset* off, size_t desc_size) {
+    ring->map_len = off->desc + XSK_RING_SIZE * desc_size;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, PRIV->xsk_fd, pgoff);
+    if (ring->map == MAP_FAILED) {
+        ring->map = NULL;
+        return FAILURE;
+    }
+    ring->producer = (uint32_t*)((uint8_t*)ring->map + off->producer);
+    ring->consumer = (uint32_t*)((uint8_t*)ring->map + off->consumer);
+    ring->descs = (uint8_t*)ring->map + off->desc;
+    ring->cached = 0;
+    return SUCCESS;
+}
+
+/*
+ * Create the socket with its UMEM and rings, and bind it to our queue
+ */
+static RESULT xdp_setup_socket(struct _if_impl* this) {
+    struct xdp_umem_reg _reg;
+    struct xdp_mmap_offsets _off;
+    struct sockaddr_xdp _addr;
+    socklen_t _optlen = sizeof(_off);
+    int _size = XSK_RING_SIZE;
+    int i;
+
+    PRIV->umem = mmap(NULL, UMEM_FRAME_NR * UMEM_FRAME_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (PRIV->umem == MAP_FAILED) {
+        PRIV->umem = NULL;
+        PR_ERRNO("UMEM 内存分配失败");
+        return FAILURE;
+    }
+
+    if ((PRIV->xsk_fd = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0)) < 0) {
+        PR_ERRNO("AF_XDP 套接字打开失败");
+        return FAILURE;
+    }
+
+    memset(&_reg, 0, sizeof(_reg));
+    _reg.addr = (uint64_t)(unsigned long)PRIV->umem;
+    _reg.len = UMEM_FRAME_NR * UMEM_FRAME_SIZE;
+    _reg.chunk_size = UMEM_FRAME_SIZE;
+    if (setsockopt(PRIV->xsk_fd, SOL_XDP, XDP_UMEM_REG, &_reg, sizeof(_reg)) < 0
+            || setsockopt(PRIV->xsk_fd, SOL_XDP, XDP_UMEM_FILL_RING, &_size, sizeof(_size)) < 0
+            || setsockopt(PRIV->xsk_fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &_size, sizeof(_size)) < 0
+            || setsockopt(PRIV->xsk_fd, SOL_XDP, XDP_RX_RING, &_size, sizeof(_size)) < 0
+            || setsockopt(PRIV->xsk_fd, SOL_XDP, XDP_TX_RING, &_size, sizeof(_size)) < 0
+            || getsockopt(PRIV->xsk_fd, SOL_XDP, XDP_MMAP_OFFSETS, &_off, &_optlen) < 0) {
+        PR_ERRNO("UMEM 设置失败");
+        return FAILURE;
+    }
+
+    if (IS_FAIL(xdp_map_ring(this, &PRIV->rx, XDP_PGOFF_RX_RING, &_off.rx, sizeof(struct xdp_desc)))
+            || IS_FAIL(xdp_map_ring(this, &PRIV->tx, XDP_PGOFF_TX_RING, &_off.tx, sizeof(struct xdp_desc)))
+            || IS_FAIL(xdp_map_ring(this, &PRIV->fill, XDP_UMEM_PGOFF_FILL_RING, &_off.fr, sizeof(uint64_t)))
+            || IS_FAIL(xdp_map_ring(this, &PRIV->comp, XDP_UMEM_PGOFF_COMPLETION_RING, &_off.cr, sizeof(uint64_t)))) {
+        PR_ERRNO("AF_XDP 环映射失败");
+        return FAILURE;
+    }
+
+    /* Receiving frames go to the kernel right away, sending ones wait in our free list */
+    for (i = 0; i < XSK_RING_SIZE; ++i) {
+        XSK_DESC(PRIV->fill, uint64_t, PRIV->fill.cached++) = (uint64_t)i * UMEM_FRAME_SIZE;
+        PRIV->tx_free[i] = (uint64_t)(XSK_RING_SIZE + i) * UMEM_FRAME_SIZE;
+    }
+    PRIV->tx_free_count = XSK_RING_SIZE;
+    __atomic_store_n(PRIV->fill.producer, PRIV->fill.cached, __ATOMIC_RELEASE);
+
+    /* Zero-copy if the driver can, copy otherwise */
+    memset(&_addr, 0, sizeof(_addr));
+    _addr.sxdp_family = AF_XDP;
+    _addr.sxdp_ifindex = PRIV->if_index;
+    _addr.sxdp_queue_id = XSK_QUEUE_ID;
+    if (bind(PRIV->xsk_fd, (struct sockaddr*)&_addr, sizeof(_addr)) < 0) {
+        PR_ERRNO("AF_XDP 套接字绑定失败");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * if (data + ETH_HLEN > data_end || eth->h_proto != htons(proto))
+ *     return XDP_PASS;
+ * return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS);
+ */
+static RESULT xdp_load_prog(struct _if_impl* this) {
+#define INSN(_code, _dst, _src, _off, _imm) \
+    {.code = (_code), .dst_reg = (_dst), .src_reg = (_src), .off = (_off), .imm = (_imm)}
+    struct bpf_insn _insns[] = {
+        INSN(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+        INSN(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, data), 0),
+        INSN(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_3, BPF_REG_6, offsetof(struct xdp_md, data_end), 0),
+        INSN(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0),
+        INSN(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, ETH_HLEN),
+        INSN(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 8, 0), /* To "pass" */
+        INSN(BPF_LDX | BPF_H | BPF_MEM, BPF_REG_4, BPF_REG_2, offsetof(struct ethhdr, h_proto), 0),
+        INSN(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_4, 0, 6, htons(PRIV->proto)), /* To "pass" */
+        INSN(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, rx_queue_index), 0),
+        INSN(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, PRIV->map_fd),
+        INSN(0, 0, 0, 0, 0), /* Upper half of the 64-bit immediate above */
+        INSN(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS),
+        INSN(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+        INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        /* pass: */
+        INSN(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS),
+        INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+    };
+    char _log[4096] = {0};
+    union bpf_attr _attr;
+
+    memset(&_attr, 0, sizeof(_attr));
+    _attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    _attr.key_size = sizeof(uint32_t);
+    _attr.value_size = sizeof(uint32_t);
+    _attr.max_entries = XSK_QUEUE_ID + 1;
+    if ((PRIV->map_fd = sys_bpf(BPF_MAP_CREATE, &_attr)) < 0) {
+        PR_ERRNO("XSKMAP 创建失败");
+        return FAILURE;
+    }
+    _insns[9].imm = PRIV->map_fd;
+
+    memset(&_attr, 0, sizeof(_attr));
+    _attr.prog_type = BPF_PROG_TYPE_XDP;
+    _attr.insns = (uint64_t)(unsigned long)_insns;
+    _attr.insn_cnt = sizeof(_insns) / sizeof(_insns[0]);
+    _attr.license = (uint64_t)(unsigned long)"GPL";
+    if ((PRIV->prog_fd = sys_bpf(BPF_PROG_LOAD, &_attr)) < 0) {
+        /* Once more for the verifier's words */
+        _attr.log_buf = (uint64_t)(unsigned long)_log;
+        _attr.log_size = sizeof(_log);
+        _attr.log_level = 1;
+        PRIV->prog_fd = sys_bpf(BPF_PROG_LOAD, &_attr);
+        PR_ERRNO("XDP 程序加载失败");
+        PR_DBG("%s", _log);
+        if (PRIV->prog_fd >= 0) {
+            close(PRIV->prog_fd);
+            PRIV->prog_fd = -1;
+        }
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static RESULT xdp_update_map(struct _if_impl* this) {
+    uint32_t _key = XSK_QUEUE_ID;
+    uint32_t _value = PRIV->xsk_fd;
+    union bpf_attr _attr;
+
+    memset(&_attr, 0, sizeof(_attr));
+    _attr.map_fd = PRIV->map_fd;
+    _attr.key = (uint64_t)(unsigned long)&_key;
+    _attr.value = (uint64_t)(unsigned long)&_value;
+    if (sys_bpf(BPF_MAP_UPDATE_ELEM, &_attr) < 0) {
+        PR_ERRNO("无法将 AF_XDP 套接字加入 XSKMAP");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Attach (or detach if `prog_fd` is -1) through RTM_SETLINK, for kernels without bpf_link.
+ * Does not replace a program someone else attached.
+ */
+static RESULT xdp_netlink_set_prog(struct _if_impl* this, int prog_fd, uint32_t flags) {
+    struct {
+        struct nlmsghdr nl_hdr;
+        struct ifinfomsg ifi;
+        uint8_t attrs[64];
+    } _req;
+    uint8_t _buf[4096];
+    struct nlmsghdr* _nl_hdr = (struct nlmsghdr*)_buf;
+    struct rtattr *_nest, *_rta;
+    int _fd, _len, _err = 0;
+
+    memset(&_req, 0, sizeof(_req));
+    _req.nl_hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    _req.nl_hdr.nlmsg_type = RTM_SETLINK;
+    _req.nl_hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    _req.ifi.ifi_family = AF_UNSPEC;
+    _req.ifi.ifi_index = PRIV->if_index;
+
+    if (prog_fd >= 0) {
+        flags |= XDP_FLAGS_UPDATE_IF_NOEXIST;
+    }
+
+    _nest = (struct rtattr*)((uint8_t*)&_req + NLMSG_ALIGN(_req.nl_hdr.nlmsg_len));
+    _nest->rta_type = IFLA_XDP | NLA_F_NESTED;
+    _nest->rta_len = RTA_LENGTH(0);
+
+    _rta = (struct rtattr*)((uint8_t*)_nest + _nest->rta_len);
+    _rta->rta_type = IFLA_XDP_FD;
+    _rta->rta_len = RTA_LENGTH(sizeof(int));
+    memmove(RTA_DATA(_rta), &prog_fd, sizeof(int));
+    _nest->rta_len += RTA_ALIGN(_rta->rta_len);
+
+    _rta = (struct rtattr*)((uint8_t*)_nest + _nest->rta_len);
+    _rta->rta_type = IFLA_XDP_FLAGS;
+    _rta->rta_len = RTA_LENGTH(sizeof(uint32_t));
+    memmove(RTA_DATA(_rta), &flags, sizeof(uint32_t));
+    _nest->rta_len += RTA_ALIGN(_rta->rta_len);
+
+    _req.nl_hdr.nlmsg_len = NLMSG_ALIGN(_req.nl_hdr.nlmsg_len) + _nest->rta_len;
+
+    if ((_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+        return FAILURE;
+    }
+    if (send(_fd, &_req, _req.nl_hdr.nlmsg_len, 0) < 0 || (_len = recv(_fd, _buf, sizeof(_buf), 0)) < 0) {
+        close(_fd);
+        return FAILURE;
+    }
+    close(_fd);
+
+    if (NLMSG_OK(_nl_hdr, _len) && _nl_hdr->nlmsg_type == NLMSG_ERROR) {
+        _err = ((struct nlmsgerr*)NLMSG_DATA(_nl_hdr))->error;
+    }
+    if (_err != 0) {
+        errno = -_err;
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Native mode first. bpf_link (Linux 5.9+) detaches by itself even if we crash,
+ * netlink is for older kernels.
+ */
+static RESULT xdp_attach_prog(struct _if_impl* this) {
+    static const struct {
+        uint32_t flags;
+        const char* name;
+    } _modes[] = {
+        {XDP_FLAGS_DRV_MODE, "原生"},
+        {XDP_FLAGS_SKB_MODE, "通用 (SKB) "},
+    };
+    union bpf_attr _attr;
+    int i;
+
+    for (i = 0; i < sizeof(_modes) / sizeof(_modes[0]); ++i) {
+        memset(&_attr, 0, sizeof(_attr));
+        _attr.link_create.prog_fd = PRIV->prog_fd;
+        _attr.link_create.target_ifindex = PRIV->if_index;
+        _attr.link_create.attach_type = BPF_XDP;
+        _attr.link_create.flags = _modes[i].flags;
+        if ((PRIV->link_fd = sys_bpf(BPF_LINK_CREATE, &_attr)) >= 0
+                || !IS_FAIL(xdp_netlink_set_prog(this, PRIV->prog_fd, _modes[i].flags))) {
+            if (PRIV->link_fd < 0) {
+                PRIV->nl_xdp_flags = _modes[i].flags;
+            }
+            PR_INFO("XDP 程序已以%s模式加载到 %s", _modes[i].name, PRIV->ifname);
+            return SUCCESS;
+        }
+        PR_DBG("XDP %s模式不可用: %s", _modes[i].name, strerror(errno));
+    }
+    PR_ERR("无法在 %s 上加载 XDP 程序", PRIV->ifname);
+    return FAILURE;
+}
+
+RESULT xdp_prepare_interface(struct _if_impl* this) {
+    if (IS_FAIL(xdp_join_groups(this))
+            || IS_FAIL(xdp_setup_socket(this))
+            || IS_FAIL(xdp_load_prog(this))
+            || IS_FAIL(xdp_update_map(this))
+            || IS_FAIL(xdp_attach_prog(this))) {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Called by the event loop when the RX ring is not empty.
+ * Frames are handed to the handler right in the UMEM,
+ * then given back to the kernel through the fill ring.
+ */
+static void xdp_on_readable(int fd, void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+    uint8_t _short_buf[sizeof(FRAME_HEADER)];
+    uint64_t _recv_usecs = get_monotonic_usecs(); /* No kernel timestamps here */
+    struct xdp_desc* _desc;
+    ETH_EAP_FRAME frame;
+
+    while (PRIV->rx.cached != __atomic_load_n(PRIV->rx.producer, __ATOMIC_ACQUIRE)) {
+        _desc = &XSK_DESC(PRIV->rx, struct xdp_desc, PRIV->rx.cached);
+        frame.content = PRIV->umem + _desc->addr;
+        frame.actual_len = _desc->len;
+        frame.buffer_len = _desc->len; /* Nothing to append here */
+        frame.recv_usecs = _recv_usecs;
+        if (frame.actual_len < sizeof(_short_buf)) {
+            /* Headers are read without checking the length */
+            memset(_short_buf, 0, sizeof(_short_buf));
+            memmove(_short_buf, frame.content, frame.actual_len);
+            frame.content = _short_buf;
+        }
+        PRIV->handler(&frame);
+
+        /* Rings are as large as the RX half of UMEM, the fill ring always has room */
+        XSK_DESC(PRIV->fill, uint64_t, PRIV->fill.cached++) = _desc->addr & ~(uint64_t)(UMEM_FRAME_SIZE - 1);
+        PRIV->rx.cached++;
+        __atomic_store_n(PRIV->rx.consumer, PRIV->rx.cached, __ATOMIC_RELEASE);
+        __atomic_store_n(PRIV->fill.producer, PRIV->fill.cached, __ATOMIC_RELEASE);
+    }
+}
+
+static void xdp_flush_tx(void* vthis);
+
+static void xdp_retry_tx(void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+
+    PRIV->tx_retry_alarm = 0;
+    xdp_flush_tx(this);
+}
+
+/*
+ * Tell the kernel to send everything in TX ring, with one syscall.
+ * If it is busy (e.g. no room in the completion ring yet), the frames are
+ * kept pending. They are kicked again by the next flush, when completions
+ * are taken back, or by an alarm shortly after, whichever comes first.
+ */
+static void xdp_kick_tx(struct _if_impl* this) {
+    if (sendto(PRIV->xsk_fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) {
+        if (errno == EAGAIN || errno == EBUSY || errno == ENOBUFS) {
+            PR_DBG("AF_XDP 发送暂时失败，稍后重试: %s", strerror(errno));
+            if (PRIV->tx_retry_alarm == 0) {
+                PRIV->tx_retry_alarm = schedule_alarm_ms(XSK_TX_RETRY_MS, xdp_retry_tx, this);
+                if (PRIV->tx_retry_alarm < 0) {
+                    PRIV->tx_retry_alarm = 0;
+                }
+            }
+            return;
+        }
+        PR_ERRNO("sendto 调用失败");
+    }
+    PRIV->tx_pending = 0;
+    if (PRIV->tx_retry_alarm) {
+        unschedule_alarm(PRIV->tx_retry_alarm);
+        PRIV->tx_retry_alarm = 0;
+    }
+}
+
+/* Take back the frames the kernel has sent */
+static void xdp_reclaim_tx(struct _if_impl* this) {
+    uint32_t _start = PRIV->comp.cached;
+
+    while (PRIV->comp.cached != __atomic_load_n(PRIV->comp.producer, __ATOMIC_ACQUIRE)) {
+        PRIV->tx_free[PRIV->tx_free_count++] = XSK_DESC(PRIV->comp, uint64_t, PRIV->comp.cached++);
+    }
+    __atomic_store_n(PRIV->comp.consumer, PRIV->comp.cached, __ATOMIC_RELEASE);
+
+    if (PRIV->comp.cached != _start && PRIV->tx_pending > 0) {
+        /* The room just made may be what the last kick was waiting for */
+        xdp_kick_tx(this);
+    }
+}
+
+/*
+ * Send everything in TX ring.
+ * Called by the event loop before it sleeps, or after each frame outside the loop.
+ */
+static void xdp_flush_tx(void* vthis) {
+    IF_IMPL* this = (IF_IMPL*)vthis;
+
+    if (PRIV->tx_pending == 0) {
+        return;
+    }
+    xdp_kick_tx(this);
+    xdp_reclaim_tx(this);
+}
+
+RESULT xdp_start_capture(struct _if_impl* this) {
+    if (IS_FAIL(event_loop_add_fd(PRIV->xsk_fd, xdp_on_readable, this))) {
+        return FAILURE;
+    }
+
+    /* Timers and signals are handled in the same loop */
+    xdp_flush_tx(this);
+    PRIV->tx_batch = TRUE;
+    event_loop_set_flush_func(xdp_flush_tx, this);
+
+    RESULT ret = event_loop_run();
+
+    event_loop_set_flush_func(NULL, NULL);
+    PRIV->tx_batch = FALSE;
+    xdp_flush_tx(this);
+    event_loop_remove_fd(PRIV->xsk_fd);
+    return ret;
+}
+
+RESULT xdp_stop_capture(struct _if_impl* this) {
+    event_loop_stop();
+    return SUCCESS;
+}
+
+RESULT xdp_send_frame(struct _if_impl* this, ETH_EAP_FRAME* frame) {
+    struct xdp_desc* _desc;
+    uint64_t _addr;
+
+    if (frame == NULL || frame->content == NULL || frame->actual_len > UMEM_FRAME_SIZE)
+        return FAILURE;
+
+    if (PRIV->tx_free_count == 0) {
+        xdp_reclaim_tx(this);
+    }
+    if (PRIV->tx_free_count == 0) {
+        xdp_flush_tx(this);
+    }
+    if (PRIV->tx_free_count == 0) {
+        PR_ERR("AF_XDP 发送缓冲区已满");
+        return FAILURE;
+    }
+
+    /* TX ring is as large as the TX half of UMEM, there is room if we have a frame */
+    _addr = PRIV->tx_free[--PRIV->tx_free_count];
+    memmove(PRIV->umem + _addr, frame->content, frame->actual_len);
+    _desc = &XSK_DESC(PRIV->tx, struct xdp_desc, PRIV->tx.cached++);
+    _desc->addr = _addr;
+    _desc->len = frame->actual_len;
+    _desc->options = 0;
+    __atomic_store_n(PRIV->tx.producer, PRIV->tx.cached, __ATOMIC_RELEASE);
+
+    PRIV->tx_pending++;
+    if (!PRIV->tx_batch) {
+        /* Nobody is going to flush it for us */
+        xdp_flush_tx(this);
+    }
+    return SUCCESS;
+}
+
+void xdp_set_frame_handler(struct _if_impl* this, void (*handler)(ETH_EAP_FRAME* frame)) {
+    PRIV->handler = handler;
+}
+
+static void xdp_unmap_ring(XSK_RING* ring) {
+    if (ring->map != NULL) {
+        munmap(ring->map, ring->map_len);
+        ring->map = NULL;
+    }
+}
+
+void xdp_destroy(IF_IMPL* this) {
+    if (PRIV->xsk_fd >= 0 && PRIV->tx.map != NULL)
+        xdp_flush_tx(this);
+    if (PRIV->tx_retry_alarm)
+        unschedule_alarm(PRIV->tx_retry_alarm);
+    if (PRIV->link_fd >= 0)
+        close(PRIV->link_fd);
+    if (PRIV->nl_xdp_flags)
+        xdp_netlink_set_prog(this, -1, PRIV->nl_xdp_flags);
+    if (PRIV->prog_fd >= 0)
+        close(PRIV->prog_fd);
+    if (PRIV->map_fd >= 0)
+        close(PRIV->map_fd);
+    xdp_unmap_ring(&PRIV->rx);
+    xdp_unmap_ring(&PRIV->tx);
+    xdp_unmap_ring(&PRIV->fill);
+    xdp_unmap_ring(&PRIV->comp);
+    if (PRIV->xsk_fd >= 0)
+        close(PRIV->xsk_fd);
+    if (PRIV->umem != NULL)
+        munmap(PRIV->umem, UMEM_FRAME_NR * UMEM_FRAME_SIZE);
+    if (PRIV->mreq_fd >= 0)
+        close(PRIV->mreq_fd);
+    chk_free((void**)&this->priv);
+    chk_free((void**)&this);
+}
+
+IF_IMPL* xdp_new() {
+    IF_IMPL* this = (IF_IMPL*)malloc(sizeof(IF_IMPL));
+    if (this == NULL) {
+        PR_ERRNO("AF_XDP 主结构内存分配失败");
+        return NULL;
+    }
+    memset(this, 0, sizeof(IF_IMPL));
+
+    /* The priv pointer in if_impl.h is a xdp_priv* here */
+    this->priv = (xdp_priv*)malloc(sizeof(xdp_priv));
+    if (this->priv == NULL) {
+        PR_ERRNO("AF_XDP 私有结构内存分配失败");
+        free(this);
+        return NULL;
+    }
+    memset(this->priv, 0, sizeof(xdp_priv));
+    PRIV->xsk_fd = -1;
+    PRIV->map_fd = -1;
+    PRIV->prog_fd = -1;
+    PRIV->link_fd = -1;
+    PRIV->mreq_fd = -1;
+
+    this->set_ifname = xdp_set_ifname;
+    this->get_ifname = xdp_get_ifname;
+    this->destroy = xdp_destroy;
+    this->setup_capture_params = xdp_setup_capture_params;
+    this->prepare_interface = xdp_prepare_interface;
+    this->start_capture = xdp_start_capture;
+    this->stop_capture = xdp_stop_capture;
+    this->send_frame = xdp_send_frame;
+    this->set_frame_handler = xdp_set_frame_handler;
+    this->name = "xdp";
+    this->description = "采用 AF_XDP 进行通信的网络接口模块，EAPOL 帧不经过协议栈";
+    return this;
+}
+IF_IMPL_INIT(xdp_new)
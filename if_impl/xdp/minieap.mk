@@ -0,0 +1,11 @@
+# Makefile for interface implementation: AF_XDP
+
+LOCAL_PATH := $(call my-dir)
+
+LOCAL_SRC_FILES := if_impl_xdp.c
+LOCAL_C_INCLUDES :=
+LOCAL_CFLAGS :=
+LOCAL_LDFLAGS :=
+LOCAL_MODULE := if_impl_xdp
+
+include $(APPEND)
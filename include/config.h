@@ -50,6 +50,16 @@ typedef enum _daemon_type {
     DAEMON_FILE_LOG
 } DAEMON_TYPE;
 
+/*
+ * Timeout and retry policy of a single EAP state.
+ * Fields set to STATE_POLICY_DEFAULT fall back to stage_timeout_ms / max_retries.
+ */
+typedef struct _state_policy {
+    int timeout_ms; /* Fixed timeout, without RTT estimation and backoff */
+    int max_retries;
+} STATE_POLICY;
+#define STATE_POLICY_DEFAULT -1
+
 /*
  * General program config
  */
@@ -90,6 +100,12 @@ typedef struct _prog_config {
     char* if_impl;
     //define DEFAULT_IF_IMPL "sockraw"
 
+    /*
+     * Selected hash provider: who computes MD5 for us?
+     * NULL = choose the fastest one at startup
+     */
+    char* hash_provider;
+
     /*
      * Selected packet plugins: how you want to alter the packets?
      */
@@ -128,11 +144,22 @@ typedef struct _prog_config {
     #define DEFAULT_MAX_FAILURES 3
 
     /*
-     * Timeout (seconds) waiting for server reply in each stage
+     * Timeout (milliseconds) waiting for server reply in each stage.
+     * Given in seconds (fractions allowed) in command line and config file.
+     * Only used until we have measured the RTT to the server.
      */
-    int stage_timeout;
+    int stage_timeout_ms;
     #define DEFAULT_STAGE_TIMEOUT 5
 
+    /*
+     * Per-state overrides of stage_timeout_ms and max_retries.
+     * E.g. probe for the server aggressively with EAPOL-Start,
+     * but give Identity/MD5-Challenge some more time.
+     */
+    STATE_POLICY start_policy;
+    STATE_POLICY identity_policy;
+    STATE_POLICY challenge_policy;
+
     /*
      * Whether to save parameters to file
      */
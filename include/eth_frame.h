@@ -62,6 +62,7 @@ typedef struct _eth_eap_frame {
         FRAME_HEADER* header; // Easier to use without a cast.
                               // But is this "best practice"?
     };
+    uint64_t recv_usecs; // CLOCK_MONOTONIC time when received, 0 = unknown
 } ETH_EAP_FRAME;
 
 #endif
@@ -0,0 +1,72 @@
+#ifndef _MINIEAP_EVENT_LOOP_H
+#define _MINIEAP_EVENT_LOOP_H
+
+#include "minieap_common.h"
+
+/*
+ * The main event loop based on epoll()
+ *
+ * Everything that may wake us up is a file descriptor watched by one epoll instance:
+ * the capture socket of if_impl, the timerfd of sched_alarm, and a signalfd for
+ * termination signals. All the callbacks are called from `event_loop_run`, not from
+ * signal handlers, so they are free to malloc, send frames or (un)schedule alarms.
+ *
+ * Linux only. Other platforms still use SIGALRM and the blocking capture loops.
+ */
+#ifdef __linux__
+
+/*
+ * Watch `fd` for readability. `func` is called with `fd` and `user` when it's readable.
+ *
+ * Return: if the fd was added to the watch list
+ */
+RESULT event_loop_add_fd(int fd, void (*func)(int fd, void* user), void* user);
+
+/*
+ * Stop watching `fd`. Safe to be called inside callbacks, even for the fd being handled.
+ */
+void event_loop_remove_fd(int fd);
+
+/*
+ * Block the termination signals (SIGHUP, SIGINT, SIGTERM) and deliver them through
+ * a signalfd instead. `func` is called in the loop with the signal number.
+ *
+ * Return: if the signalfd was set up
+ */
+RESULT event_loop_watch_signals(void (*func)(int signo));
+
+/*
+ * `func` is called with `user` every time the loop is about to wait again, after all
+ * callbacks of the last wakeup returned. For sending what they have queued in one go.
+ * Only one can be set, NULL to clear.
+ */
+void event_loop_set_flush_func(void (*func)(void* user), void* user);
+
+/*
+ * Replace epoll_wait() in the loop with `func`, for an if_impl that waits on something
+ * else (io_uring). `func` blocks until anything happens and handles its own events,
+ * the epoll fd `epfd` being one of the things it waits for.
+ *
+ * Return of `func`: 1 if `epfd` is readable and the watchers should be dispatched,
+ *                   0 if not, -1 on errors with errno set
+ * Only one can be set, NULL to go back to epoll_wait().
+ */
+void event_loop_set_wait_func(int (*func)(int epfd, void* user), void* user);
+
+/*
+ * Run the loop until `event_loop_stop` is called.
+ * This is blocking.
+ *
+ * Return: FAILURE if epoll_wait failed with errors other than EINTR
+ */
+RESULT event_loop_run();
+void event_loop_stop();
+
+/*
+ * Create/destroy the epoll instance
+ */
+RESULT event_loop_init();
+void event_loop_destroy();
+
+#endif /* __linux__ */
+#endif
@@ -0,0 +1,72 @@
+#ifndef _MINIEAP_HASH_PROVIDER_H
+#define _MINIEAP_HASH_PROVIDER_H
+
+#include "minieap_common.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Hash provider: where the standard hashes are computed
+ *
+ * "builtin" is the portable C code in md5.c and always available.
+ * "af_alg" uses Linux kernel crypto API, which may be backed by
+ * crypto engines on some SoCs. "openssl" uses libcrypto, if built with
+ * ENABLE_OPENSSL.
+ *
+ * Only MD5 goes through here. The Whirlpool in RJv3 V4 hash is a modified
+ * one (different S-box, IV and round function), which no other backend implements.
+ */
+
+/* Input of the hash, so callers do not need to concatenate the pieces themselves */
+typedef struct _hash_chunk {
+    const void* data;
+    size_t len;
+} HASH_CHUNK;
+
+#define HASH_MAX_CHUNKS 8
+
+typedef struct _hash_provider {
+    const char* name;
+    const char* description;
+
+    /*
+     * Check if the backend is usable and allocate resources (sockets, contexts)
+     *
+     * Return: if the backend is usable
+     */
+    RESULT (*init)();
+
+    void (*destroy)();
+
+    /*
+     * MD5 of the concatenation of `count` (<= HASH_MAX_CHUNKS) chunks.
+     * May be called concurrently (see checkV4.h), keep no state between calls.
+     *
+     * Return: if the digest is written to `digest`
+     */
+    RESULT (*md5v)(const HASH_CHUNK* chunks, int count, uint8_t digest[16]);
+} HASH_PROVIDER;
+
+/*
+ * Choose the backend by name. NULL or "auto" means running a quick benchmark
+ * on every usable backend and choosing the fastest one.
+ *
+ * Return: FAILURE if the named backend is unknown or unusable
+ */
+RESULT hash_provider_init(const char* name);
+void hash_provider_destroy();
+
+/*
+ * Name of current backend
+ */
+const char* hash_provider_name();
+
+/*
+ * MD5 via current backend. Falls back to builtin on errors, so this always succeeds.
+ *
+ * Return: `digest`
+ */
+uint8_t* hash_md5v(const HASH_CHUNK* chunks, int count, uint8_t digest[16]);
+
+#endif
@@ -3,8 +3,8 @@
  *
  * The implementations provide unified functions to access network.
  *
- * Every implementation must implement ALL of the following functions,
- * as well as a `new()` function which constructs its _if_impl structure (produce a new instance).
+ * Every implementation must implement ALL of the following functions (except those
+ * marked optional), as well as a `new()` function which constructs its _if_impl structure (produce a new instance).
  * The `new()` function must be registered by IF_IMPL_INIT() macro.
  *
  * Each member function takes the pointer to the structure/instance as first parameter.
@@ -79,6 +79,9 @@ typedef struct _if_impl {
      * Can be used to launch/terminate the actual capturing loop.
      * Note: `start_capture` should be blocking.
      *
+     * On Linux, add the capture fd to the event loop and run `event_loop_run()` here,
+     * since scheduled alarms are served by that loop as well. See include/event_loop.h.
+     *
      * Return: if capturing started/stopped successfully (no use in start_capture since it's blocking)
      */
     RESULT (*start_capture)(struct _if_impl* this);
@@ -98,9 +101,17 @@ typedef struct _if_impl {
      *
      * Note: the `frame` pointer does not guarantee to be valid after this
      * handler returns. If you want to use it afterwards, make a copy yourselves.
+     * It may point into memory shared with the kernel, do not modify it.
      */
     void (*set_frame_handler)(struct _if_impl* this, void (*handler)(ETH_EAP_FRAME* frame));
 
+    /*
+     * Optional, can be NULL.
+     * Only frames from `mac` are of interest from now on, or from anyone if `mac` is NULL.
+     * Implementations may use this to drop frames of others before they reach us.
+     */
+    void (*set_peer_mac)(struct _if_impl* this, const uint8_t* mac);
+
     /*
      * Implementation name, to be shown and selected by user
      */
@@ -39,5 +39,6 @@ void MD5Update(MD5_CTX *context, UCHAR *input, UINT4 inputLen);
 void MD5Final(UCHAR digest[16], MD5_CTX *context);
 
 UCHAR* ComputeHash(UCHAR *src, UINT4 len);
+UCHAR* md5_digest_r(const UCHAR *src, UINT4 len, UCHAR digest[16]);
 
 #endif /* MD5_H */
@@ -59,4 +59,30 @@ void strarrayprint(int count, char* array[]);
  * Similar to strndup but without trailing 0
  */
 void* memdup(const void* src, int n);
+
+/*
+ * Similar to system(), but the command starts with an empty signal mask.
+ * The event loop blocks termination signals, and scripts (DHCP clients
+ * for example) should not inherit that.
+ */
+int my_system(const char* cmd);
+
+/*
+ * Microseconds on CLOCK_MONOTONIC, for timers and intervals
+ */
+uint64_t get_monotonic_usecs();
+
+/*
+ * Map a recent CLOCK_REALTIME timestamp (e.g. packet timestamps from kernel)
+ * to CLOCK_MONOTONIC, by its distance to current time
+ */
+uint64_t realtime_to_monotonic_usecs(uint64_t realtime_usecs);
+
+/*
+ * Convert between seconds in string ("1.5") and milliseconds (1500).
+ * `secs_str2ms` returns -1 on malformed input.
+ * `buf` of `ms2secs_str` should hold at least 12 bytes.
+ */
+int secs_str2ms(const char* str);
+char* ms2secs_str(int ms, char* buf);
 #endif
@@ -30,8 +30,11 @@ RESULT obtain_iface_ip_mask(const char* ifname, LIST_ELEMENT** list);
 void free_ip_list(LIST_ELEMENT** list);
 IP_ADDR* find_ip_with_family(LIST_ELEMENT* list, short family);
 
+#define RESOLV_CONF_PATH "/etc/resolv.conf"
+
 /*
- * Obtain a list of DNS servers in /etc/resolv.conf
+ * Obtain a list of DNS servers in /etc/resolv.conf, or the file
+ * given to dns_cache_init()
  *
  * Remember to free the list after usage.
  *
@@ -41,4 +44,36 @@ RESULT obtain_dns_list(LIST_ELEMENT** list);
 void free_dns_list(LIST_ELEMENT** list);
 
 RESULT obtain_iface_ipv4_gateway(const char* ifname, uint8_t* buf);
+
+#ifdef __linux__
+/*
+ * Cache MAC, IP addresses and IPv4 default gateway of `ifname`, kept up to date by
+ * netlink notifications through the event loop. obtain_iface_mac(), obtain_iface_ip_mask()
+ * and obtain_iface_ipv4_gateway() read from the cache for this interface, instead of
+ * walking all interfaces or routes.
+ *
+ * Return: if the cache is ready. Lookups work without the cache, just slower.
+ */
+RESULT iface_cache_init(const char* ifname);
+void iface_cache_destroy();
+
+/*
+ * Cache the nameservers in `path` (usually RESOLV_CONF_PATH) for obtain_dns_list(),
+ * refreshed when inotify reports a change through the event loop.
+ *
+ * Return: if the cache is ready. Lookups work without the cache, just slower.
+ */
+RESULT dns_cache_init(const char* path);
+void dns_cache_destroy();
+#endif
+
+/*
+ * Bring the caches up to date and tell if anything has changed since last call,
+ * so the results of lookups can be kept by the caller.
+ *
+ * Return: a number that changes along with what the cache holds for `ifname`
+ *         (or resolv.conf). 0 if the cache is not in use, and lookups have to be done again.
+ */
+uint32_t iface_cache_generation(const char* ifname);
+uint32_t dns_cache_generation();
 #endif
@@ -16,6 +16,13 @@
  */
 RESULT append_to_frame(ETH_EAP_FRAME* frame, const uint8_t* data, int len);
 
+/*
+ * Copy content of `src` into the buffer of `dst`
+ *
+ * Return: FAILURE if it does not fit
+ */
+RESULT frame_copy(ETH_EAP_FRAME* dst, const ETH_EAP_FRAME* src);
+
 /*
  * Duplicate a frame and its content
  */
@@ -0,0 +1,51 @@
+#ifndef _MINIEAP_RTT_ESTIMATOR_H
+#define _MINIEAP_RTT_ESTIMATOR_H
+
+#include <stdint.h>
+
+/*
+ * Retransmission timeout estimator, the same way as TCP does (RFC 6298)
+ *
+ * Feed it with RTT samples of request/response exchanges, and it keeps
+ * a smoothed RTT (SRTT) and its variation (RTTVAR). RTO = SRTT + 4 * RTTVAR,
+ * clamped to [min_rto_ms, max_rto_ms].
+ *
+ * Every timeout doubles the RTO (exponential backoff) until a new valid sample
+ * arrives. Do not sample retransmitted exchanges (Karn's algorithm), since
+ * we can't tell which copy the reply is for.
+ *
+ * Before the first sample, RTO is `initial_rto_ms`.
+ */
+typedef struct _rtt_estimator {
+    uint64_t srtt_us; /* Smoothed RTT */
+    uint64_t rttvar_us;
+    int samples; /* 0 = no valid sample yet */
+    int backoff; /* Number of timeouts since last valid sample */
+    int initial_rto_ms;
+    int min_rto_ms;
+    int max_rto_ms;
+} RTT_ESTIMATOR;
+
+void rtt_estimator_init(RTT_ESTIMATOR* est, int initial_rto_ms, int min_rto_ms, int max_rto_ms);
+
+/*
+ * Take a new RTT sample. This also clears the backoff.
+ */
+void rtt_estimator_sample(RTT_ESTIMATOR* est, uint64_t rtt_us);
+
+/*
+ * Called when the timer expires and we are going to retransmit
+ */
+void rtt_estimator_backoff(RTT_ESTIMATOR* est);
+
+/*
+ * Clear the backoff without sampling, e.g. when a new session starts
+ */
+void rtt_estimator_reset_backoff(RTT_ESTIMATOR* est);
+
+/*
+ * Current RTO with backoff applied
+ */
+int rtt_estimator_rto_ms(const RTT_ESTIMATOR* est);
+
+#endif
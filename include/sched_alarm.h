@@ -1,29 +1,55 @@
 #ifndef _MINIEAP_SCHED_ALARM_H
 #define _MINIEAP_SCHED_ALARM_H
 
+#include <stdint.h>
+
 /*
- * The scheduler based on alarm()
+ * The scheduler based on a timer queue
+ *
+ * It will call `func` after `secs` seconds (or `msecs` milliseconds), and pass `user` as
+ * the argument to `func`. `schedule_alarm*` returns the job ID. `unschedule_alarm` needs
+ * this ID to remove the corresponding alarm event. IDs of fired or removed events are never
+ * reused immediately, so it's safe to unschedule a stale ID.
  *
- * It will call `func` after `secs` seconds, and pass `user` as the argument to `func`.
- * `schedule_alarm` returns the job ID. `unschedule_alarm` needs this ID to remove the
- * corresponding alarm event.
+ * Periodic alarms call `func` at `first_msecs`, `first_msecs + period_msecs`,
+ * `first_msecs + 2 * period_msecs` ... after scheduling, all anchored to CLOCK_MONOTONIC.
+ * The period does not drift even if `func` itself or the system is slow.
+ * `period_msecs` = 0 makes it an one-shot alarm.
  *
  * Details:
- * We know that later calls to alarm() will override the time value set by previous calls,
- * and alarm(0) cancels the timer and returns time left to next alarm.
+ * Events are kept in a binary min-heap by their absolute deadlines, and the underlying timer
+ * is always set to the nearest one. Scheduling and unscheduling take O(log n).
  *
- * We can make a list of events to be executed, and always set alarm() to time to nearest event.
- * This time value is stored for further use.
+ * On Linux, the timer is a timerfd watched by the event loop, so `func` is called from
+ * the event loop. On other platforms it's setitimer(), and `func` is called in SIGALRM handler.
  *
- * When the alarm goes off, we know that stored number of seconds has passed, and update the list
- * subtracting the time value from other events. Then we find the nearest event and set alarm() again.
+ * Return: the job ID, or -1 if the queue is full
  */
 int schedule_alarm(int secs, void (*func)(void*), void* user);
+int schedule_alarm_ms(int msecs, void (*func)(void*), void* user);
+int schedule_periodic_alarm_ms(int first_msecs, int period_msecs, void (*func)(void*), void* user);
 void unschedule_alarm(int id);
 
 /*
- * Initializes the scheduler. E.g. install the signal handler.
+ * Initializes the scheduler. E.g. install the signal handler, or create the timerfd.
+ * On Linux, the event loop must be ready before this.
  */
 RESULT sched_alarm_init();
 void sched_alarm_destroy();
+
+#ifdef __linux__
+/*
+ * Keep the time by something other than the timerfd, e.g. timeouts in an io_uring.
+ * `func` is called with `user` and the nearest deadline (absolute CLOCK_MONOTONIC time
+ * in ms, 0 if nothing is scheduled) every time the timer would be re-armed,
+ * and `sched_alarm_ring` must be called when that time comes.
+ * NULL to go back to the timerfd.
+ */
+void sched_alarm_set_timer_func(void (*func)(uint64_t deadline_ms, void* user), void* user);
+
+/*
+ * Fire everything due and re-arm the timer
+ */
+void sched_alarm_ring();
+#endif
 #endif
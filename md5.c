@@ -285,13 +285,19 @@ static void Decode (UINT4 *output, UCHAR *input, UINT4 len)
    (((UINT4)input[j+2]) << 16) | (((UINT4)input[j+3]) << 24);
 }
 
-/*Compute the md5sum (return static-local-variable),whose length is 16 bytes.*/
-UCHAR* ComputeHash(UCHAR* src, UINT4 len)
+/*Compute the md5sum into caller's buffer, whose length is 16 bytes. Returns `digest`.*/
+UCHAR* md5_digest_r(const UCHAR* src, UINT4 len, UCHAR digest[16])
 {
    MD5_CTX context;
-   static UCHAR digest[16];
    MD5Init(&context);
-   MD5Update(&context, src, len);
+   MD5Update(&context, (UCHAR*)src, len);
    MD5Final(digest, &context);
    return digest;
 }
+
+/*Compute the md5sum (return static-local-variable),whose length is 16 bytes.*/
+UCHAR* ComputeHash(UCHAR* src, UINT4 len)
+{
+   static UCHAR digest[16];
+   return md5_digest_r(src, len, digest);
+}
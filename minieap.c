@@ -8,6 +8,9 @@
 #include "misc.h"
 #include "conf_parser.h"
 #include "pid_lock.h"
+#include "event_loop.h"
+#include "hash_provider.h"
+#include "net_util.h"
 
 #include <stdlib.h>
 #include <errno.h>
@@ -134,6 +137,12 @@ static int init_if() {
         return FAILURE;
     }
 
+#ifdef __linux__
+    if (IS_FAIL(iface_cache_init(cfg->ifname))) {
+        PR_WARN("接口信息缓存启用失败，将每次重新查询接口信息");
+    }
+#endif
+
     if (IS_FAIL(if_impl->setup_capture_params(if_impl, ETH_P_PAE, FALSE))) {
         PR_ERR("设置捕获参数失败");
         return FAILURE;
@@ -169,6 +178,12 @@ static void exit_handler() {
     packet_plugin_destroy();
     eap_state_machine_destroy();
     sched_alarm_destroy();
+    hash_provider_destroy();
+#ifdef __linux__
+    iface_cache_destroy();
+    dns_cache_destroy();
+    event_loop_destroy();
+#endif
     pid_lock_destroy();
     free_config();
     PR_INFO("MiniEAP 已退出");
@@ -185,14 +200,31 @@ static void signal_handler(int signal) {
 int main(int argc, char* argv[]) {
     srand(time(0));
     atexit(exit_handler);
+#ifndef __linux__
 	signal(SIGHUP, signal_handler);
 	signal(SIGINT, signal_handler);
 	signal(SIGTERM, signal_handler);
+#endif
 
     if (IS_FAIL(init_cfg(argc, argv))) {
         return FAILURE;
     }
 
+    if (IS_FAIL(hash_provider_init(get_program_config()->hash_provider))) {
+        return FAILURE;
+    }
+
+#ifdef __linux__
+    /* Signals are delivered to the event loop, see event_loop.h */
+    if (IS_FAIL(event_loop_init()) || IS_FAIL(event_loop_watch_signals(signal_handler))) {
+        return FAILURE;
+    }
+
+    if (IS_FAIL(dns_cache_init(RESOLV_CONF_PATH))) {
+        PR_WARN("DNS 信息缓存启用失败，将每次重新读取 " RESOLV_CONF_PATH);
+    }
+#endif
+
     if (IS_FAIL(init_if())) {
         return FAILURE;
     }
@@ -13,7 +13,7 @@
 #include "eth_frame.h"
 #include "logging.h"
 #include "misc.h"
-#include "md5.h"
+#include "hash_provider.h"
 
 typedef struct _packet_builder_priv {
     FRAME_HEADER frame_header;
@@ -26,17 +26,15 @@ static PACKET_BUILDER* g_builder = NULL;
 
 #define PRIV ((packet_builder_priv*)(this->priv))
 
-/* Original MentoHUST flavor, with function name changed */
-static uint8_t* hash_md5_pwd(uint8_t id, const uint8_t *md5Seed, int seedLen, const char* password)
+/* Original MentoHUST flavor, with function name changed. Result goes to `digest` */
+static uint8_t* hash_md5_pwd(uint8_t id, const uint8_t *md5Seed, int seedLen, const char* password, uint8_t* digest)
 {
-	uint8_t md5Src[80];
-	int md5Len = strlen(password);
-	md5Src[0] = id;
-	memcpy(md5Src + 1, password, md5Len);
-	md5Len++;
-	memcpy(md5Src + md5Len, md5Seed, seedLen);
-	md5Len += seedLen;
-	return ComputeHash(md5Src, md5Len);
+	HASH_CHUNK chunks[3] = {
+		{&id, 1},
+		{password, strlen(password)},
+		{md5Seed, seedLen}
+	};
+	return hash_md5v(chunks, 3, digest);
 }
 
 void builder_set_eth_field(struct _packet_builder* this, int field, const uint8_t* val) {
@@ -123,9 +121,8 @@ int builder_build_packet(struct _packet_builder* this, uint8_t* buffer) {
                 return -1;
             }
 
-            memmove(_challenge, hash_md5_pwd(PRIV->frame_header.eap_hdr.id[0], PRIV->md5_seed,
-                                             PRIV->seed_len, PRIV->eap_config->password),
-                    MD5_CHALLENGE_DIGEST_SIZE);
+            hash_md5_pwd(PRIV->frame_header.eap_hdr.id[0], PRIV->md5_seed,
+                         PRIV->seed_len, PRIV->eap_config->password, _challenge);
             /* Extra field: MD5-Value-Size (1 byte) */
             buffer[_copied_bytes] = MD5_CHALLENGE_DIGEST_SIZE;
             _copied_bytes += 1;
@@ -26,8 +26,6 @@ void rjv3_destroy(struct _packet_plugin* this) {
     chk_free((void**)&PRIV->fake_dns1);
     chk_free((void**)&PRIV->fake_dns2);
     chk_free((void**)&PRIV->fake_serial);
-    list_destroy(&PRIV->cmd_prop_list, TRUE);
-    list_destroy(&PRIV->cmd_prop_mod_list, TRUE);
     chk_free((void**)&this->priv);
     chk_free((void**)&this);
 }
@@ -35,7 +33,8 @@ void rjv3_destroy(struct _packet_plugin* this) {
 static void rjv3_reset_state(PACKET_PLUGIN* this) {
     PRIV->dhcp_count = 0;
     PRIV->succ_count = 0;
-    PRIV->last_recv_packet = NULL;
+    PRIV->last_recv_md5 = FALSE;
+    rjv3_invalidate_templates(this);
     rjv3_keepalive_reset();
 }
 
@@ -74,11 +73,11 @@ static RESULT append_rj_cmdline_opt(struct _packet_plugin* this, const char* opt
 
     _split = strtok(NULL, ":");
     if (_split != NULL && _split[0] == 'r') {
-        if (append_rjv3_prop(&PRIV->cmd_prop_mod_list, _type, _content_buf, _content_len) < 0) {
+        if (rjv3_props_append(&PRIV->cmd_mod_props, _type, _content_buf, _content_len) < 0) {
             goto fail;
         }
     } else {
-        if (append_rjv3_prop(&PRIV->cmd_prop_list, _type, _content_buf, _content_len) < 0) {
+        if (rjv3_props_append(&PRIV->cmd_props, _type, _content_buf, _content_len) < 0) {
             goto fail;
         }
     }
@@ -226,15 +225,14 @@ static RESULT rjv3_process_success(struct _packet_plugin* this, ETH_EAP_FRAME* f
             PR_INFO("首次认证成功，正在执行 DHCP 脚本以准备第二次认证");
 
             /*
-             * PRIV->last_recv_packet == `frame`, but `frame` will be freed
-             * once the state transition is finished. We need to keep it
+             * `frame` is only valid during this call. We need to keep it
              * in case DHCP fails and we need to start heartbeating.
              */
             if (PRIV->duplicated_packet != NULL) {
                 free_frame(&PRIV->duplicated_packet);
             }
             PRIV->duplicated_packet = frame_duplicate(frame);
-            system(PRIV->dhcp_script);
+            my_system(PRIV->dhcp_script);
 
             /* Try right after the script ends */
             rjv3_start_secondary_auth(this);
@@ -250,7 +248,7 @@ static RESULT rjv3_process_success(struct _packet_plugin* this, ETH_EAP_FRAME* f
         }
     } else if (PRIV->dhcp_type == DHCP_AFTER_AUTH) {
         /* Run script after one-pass authentication finishes */
-        system(PRIV->dhcp_script);
+        my_system(PRIV->dhcp_script);
     }
 
     if (IS_FAIL(rjv3_process_result_prop(frame))) {
@@ -258,7 +256,7 @@ static RESULT rjv3_process_success(struct _packet_plugin* this, ETH_EAP_FRAME* f
     }
 
     PR_INFO("正定时发送 Keep-Alive 报文以保持在线……");
-    schedule_alarm(1, rjv3_send_keepalive_timed, this);
+    rjv3_start_keepalive(this);
     return SUCCESS;
 }
 
@@ -269,7 +267,7 @@ static RESULT rjv3_process_failure(PACKET_PLUGIN* this, ETH_EAP_FRAME* frame) {
 }
 
 RESULT rjv3_on_frame_received(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
-    PRIV->last_recv_packet = frame;
+    rjv3_save_last_recv(this, frame);
 
     if (frame->header->eapol_hdr.type[0] == EAP_PACKET) {
         if (frame->header->eap_hdr.code[0] == EAP_SUCCESS) {
@@ -293,7 +291,7 @@ RESULT rjv3_process_config_file(struct _packet_plugin* this, const char* filepat
     return SUCCESS;
 }
 
-static void rjv3_save_one_prop(void* prop, void* is_mod) {
+static void rjv3_save_one_prop(const RJ_PROP* prop, int is_mod) {
 #define TO_RJ_PROP(x) ((RJ_PROP*)x)
                        /*                                      6f   : */
     int prop_str_len = sizeof(TO_RJ_PROP(prop)->header2.type) * 2 + 1
@@ -329,13 +327,20 @@ static void rjv3_save_one_prop(void* prop, void* is_mod) {
     free(prop_str);
 }
 
+static void rjv3_save_props(const RJV3_PROPS* props, int is_mod) {
+    int i;
+    for (i = 0; i < props->count; ++i) {
+        rjv3_save_one_prop(rjv3_props_at(props, i), is_mod);
+    }
+}
+
 void rjv3_save_config(struct _packet_plugin* this) {
     char itoa_buf[10];
     conf_parser_add_value("heartbeat", my_itoa(PRIV->heartbeat_interval, itoa_buf, 10));
     conf_parser_add_value("eap-bcast-addr", my_itoa(PRIV->bcast_addr, itoa_buf, 10));
     conf_parser_add_value("dhcp-type", my_itoa(PRIV->dhcp_type, itoa_buf, 10));
-    list_traverse(PRIV->cmd_prop_list, rjv3_save_one_prop, FALSE);
-    list_traverse(PRIV->cmd_prop_mod_list, rjv3_save_one_prop, (void*)TRUE); /* No warning! */
+    rjv3_save_props(&PRIV->cmd_props, FALSE);
+    rjv3_save_props(&PRIV->cmd_mod_props, TRUE);
     conf_parser_add_value("service", PRIV->service_name);
     conf_parser_add_value("version-str", PRIV->ver_str);
     conf_parser_add_value("dhcp-script", PRIV->dhcp_script);
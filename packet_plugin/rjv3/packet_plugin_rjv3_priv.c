@@ -47,15 +47,12 @@ static void rjv3_set_local_mac(uint8_t* mac_buf) {
     obtain_iface_mac(ifname, mac_buf);
 }
 
-static void rjv3_set_pwd_hash(uint8_t* hash_buf, ETH_EAP_FRAME* request) {
-    if (IS_MD5_FRAME(request)) {
-        uint8_t* _hash_buf;
+/* `md5_value` is from the last MD5-Challenge, NULL if the last frame is not one */
+static void rjv3_set_pwd_hash(uint8_t* hash_buf, const uint8_t* md5_value) {
+    if (md5_value != NULL) {
         EAP_CONFIG* _eap_config = get_eap_config();
 
-        _hash_buf = (uint8_t*)computePwd(request->content + sizeof(FRAME_HEADER) + 1,
-                                          _eap_config->username, _eap_config->password);
-        memmove(hash_buf, _hash_buf, 16);
-        /* 1 = sizeof(MD5-Value-Size), this is where MD5-Value starts */
+        computePwd_r(md5_value, _eap_config->username, _eap_config->password, (char*)hash_buf);
     }
 }
 
@@ -68,10 +65,9 @@ static void rjv3_set_ipv6_addr(uint8_t* ll_slaac, uint8_t* ll_temp, uint8_t* glo
     _if_impl->get_ifname(_if_impl, ifname, IFNAMSIZ);
 
     obtain_iface_ip_mask(ifname, &_ip_list);
-    _ip_curr = _ip_list;
 
 #define IP_ELEM ((IP_ADDR*)(_ip_curr->content))
-    do {
+    for (_ip_curr = _ip_list; _ip_curr != NULL; _ip_curr = _ip_curr->next) {
         if (IP_ELEM->family == AF_INET6) {
             if ((IP_ELEM->ip[0] & 0xf0) == 0x20) { // 2xxx:: Global scope (ROUGH)
                 memmove(global, IP_ELEM->ip, 16);
@@ -85,22 +81,23 @@ static void rjv3_set_ipv6_addr(uint8_t* ll_slaac, uint8_t* ll_temp, uint8_t* glo
                 }
             }
         }
-    } while ((_ip_curr = _ip_curr->next));
+    }
     list_destroy(&_ip_list, TRUE);
 }
 
-static void rjv3_set_v3_hash(uint8_t* hash_buf, ETH_EAP_FRAME* request) {
-    uint8_t* _v3_buf;
+/* Hash of the zero padding, used when the request is not MD5-Challenge */
+static void rjv3_set_v3_pad_hash(uint8_t* hash_buf) {
+    uint8_t _v3_pad[RJV3_PAD_SIZE] = {0};
+    computeV4_r(_v3_pad, RJV3_PAD_SIZE, hash_buf);
+}
 
-    /* computeV4 returns its internal buffer, which can not be freed */
-    if (IS_MD5_FRAME(request)) {
-        _v3_buf = computeV4(request->content + sizeof(FRAME_HEADER) + 1, /* position of MD5-Value */
-                            *(request->content + sizeof(FRAME_HEADER))); /* position of MD5-Value-Size */
+/* `hash_buf` and `pad_hash` should hold RJV3_SIZE_V3_HASH bytes */
+static void rjv3_set_v3_hash(uint8_t* hash_buf, const uint8_t* md5_value, int md5_len, const uint8_t* pad_hash) {
+    if (md5_value != NULL) {
+        computeV4_r(md5_value, md5_len, hash_buf);
     } else {
-        uint8_t _v3_pad[RJV3_PAD_SIZE] = {0};
-        _v3_buf = computeV4(_v3_pad, RJV3_PAD_SIZE);
+        memmove(hash_buf, pad_hash, RJV3_SIZE_V3_HASH);
     }
-    memmove(hash_buf, _v3_buf, 0x80);
 }
 
 static void rjv3_set_service_name(uint8_t* name_buf, char* cmd_opt) {
@@ -129,7 +126,7 @@ static void rjv3_set_secondary_dns(char* dns_ascii_buf, char* fake_dns) {
 
 static void rjv3_set_hdd_serial(uint8_t* serial_buf, char* fake_serial) {
     if (fake_serial != NULL) {
-        memmove(serial_buf, fake_serial, strnlen(fake_serial, MAX_PROP_LEN));
+        memmove(serial_buf, fake_serial, strnlen(fake_serial, RJV3_SIZE_HDD_SER));
         return;
     }
 #ifdef __linux__
@@ -184,6 +181,26 @@ close_return:
 }
 
 #define PRIV ((rjv3_priv*)(this->priv))
+#define LAST_MD5_VALUE (PRIV->last_recv_md5 ? PRIV->md5_value : NULL)
+
+/*
+ * Frames received may be in a ring shared with the kernel, so keep
+ * the only thing needed later, MD5-Value of the request
+ */
+void rjv3_save_last_recv(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
+    /* 1 = sizeof(MD5-Value-Size), this is where MD5-Value starts */
+    int _avail = (int)frame->actual_len - (int)sizeof(FRAME_HEADER) - 1;
+
+    PRIV->last_recv_md5 = IS_MD5_FRAME(frame) && _avail >= 0;
+    if (!PRIV->last_recv_md5) {
+        return;
+    }
+
+    PRIV->md5_value_len = *(frame->content + sizeof(FRAME_HEADER));
+    memset(PRIV->md5_value, 0, sizeof(PRIV->md5_value));
+    memmove(PRIV->md5_value, frame->content + sizeof(FRAME_HEADER) + 1,
+            _avail < PRIV->md5_value_len ? _avail : PRIV->md5_value_len);
+}
 
 static RESULT rjv3_get_dhcp_lease(struct _packet_plugin* this, DHCP_LEASE* lease) {
     IF_IMPL* _if = get_if_impl();
@@ -261,14 +278,15 @@ static void rjv3_apply_bcast_addr(PACKET_PLUGIN* this, ETH_EAP_FRAME* frame) {
 }
 
 /*
- * Calculate values for commonly seen fields, and add them to a list
+ * Calculate values for commonly seen fields, and add them to a prop set
  *
- * Returns how much space it would take to "serialize" all the fields in the list
+ * Returns how much space it would take to "serialize" all the fields in the set
  */
-static int rjv3_append_common_fields(PACKET_PLUGIN* this, LIST_ELEMENT** list, int append_pwd_hash) {
+static int rjv3_append_common_fields(PACKET_PLUGIN* this, RJV3_PROPS* props, int append_pwd_hash,
+                                     const uint8_t* v3_pad_hash) {
     int _len = 0, _this_len = -1;
     uint8_t _dhcp_en[RJV3_SIZE_DHCP] = {0x00, 0x00, 0x00, 0x01};
-    uint8_t _local_mac[RJV3_SIZE_MAC];
+    uint8_t _local_mac[RJV3_SIZE_MAC] = {0};
     uint8_t _pwd_hash[RJV3_SIZE_PWD_HASH] = {0};
     char _sec_dns[INET6_ADDRSTRLEN] = {0};
     uint8_t _misc_2[RJV3_SIZE_MISC_2] = {0x01};
@@ -287,17 +305,22 @@ static int rjv3_append_common_fields(PACKET_PLUGIN* this, LIST_ELEMENT** list, i
 
     rjv3_set_local_mac(_local_mac);
 
-    rjv3_set_pwd_hash(_pwd_hash, PRIV->last_recv_packet);
+    rjv3_set_pwd_hash(_pwd_hash, LAST_MD5_VALUE);
 
     rjv3_set_secondary_dns(_sec_dns, PRIV->fake_dns2);
 
     rjv3_set_ipv6_addr(_ll_ipv6, _ll_ipv6_tmp, _glb_ipv6);
 
-    rjv3_set_v3_hash(_v3_hash, PRIV->last_recv_packet);
+    rjv3_set_v3_hash(_v3_hash, LAST_MD5_VALUE, PRIV->md5_value_len, v3_pad_hash);
 
     rjv3_set_service_name(_service, PRIV->service_name);
 
-    rjv3_set_hdd_serial(_hdd_ser, PRIV->fake_serial);
+    /* Not going to change while we are running */
+    if (!PRIV->hdd_serial_read) {
+        rjv3_set_hdd_serial(PRIV->hdd_serial, PRIV->fake_serial);
+        PRIV->hdd_serial_read = TRUE;
+    }
+    memmove(_hdd_ser, PRIV->hdd_serial, sizeof(_hdd_ser));
 
 #define CHK_ADD(x) \
     _this_len = x; \
@@ -307,27 +330,27 @@ static int rjv3_append_common_fields(PACKET_PLUGIN* this, LIST_ELEMENT** list, i
         _len += _this_len; \
     }
 
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_DHCP,     _dhcp_en,               sizeof(_dhcp_en)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_MAC,      _local_mac,             sizeof(_local_mac)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_DHCP,     _dhcp_en,               sizeof(_dhcp_en)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_MAC,      _local_mac,             sizeof(_local_mac)));
 
     if (append_pwd_hash) {
-        CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_PWD_HASH, _pwd_hash,          sizeof(_pwd_hash)));
+        CHK_ADD(rjv3_props_append(props, RJV3_TYPE_PWD_HASH, _pwd_hash,          sizeof(_pwd_hash)));
     } else {
-        CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_PWD_HASH, NULL,               0));
-    }
-
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_SEC_DNS,  (uint8_t*)_sec_dns,    strlen(_sec_dns)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_MISC_2,   _misc_2,                sizeof(_misc_2)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_LL_IPV6,  _ll_ipv6,               sizeof(_ll_ipv6)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_LL_IPV6_T,_ll_ipv6_tmp,           sizeof(_ll_ipv6_tmp)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_GLB_IPV6, _glb_ipv6,              sizeof(_glb_ipv6)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_V3_HASH,  _v3_hash,               sizeof(_v3_hash)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_SERVICE,  _service,               sizeof(_service)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_HDD_SER,  _hdd_ser,               sizeof(_hdd_ser)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_MISC_6,   NULL,                   0));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_MISC_7,   _misc_7,                sizeof(_misc_7)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_OS_BITS,  _os_bits,               sizeof(_os_bits)));
-    CHK_ADD(append_rjv3_prop(list, RJV3_TYPE_VER_STR,  (uint8_t*)_ver_str,    strlen(_ver_str) + 1)); // Zero terminated
+        CHK_ADD(rjv3_props_append(props, RJV3_TYPE_PWD_HASH, NULL,               0));
+    }
+
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_SEC_DNS,  (uint8_t*)_sec_dns,    strlen(_sec_dns)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_MISC_2,   _misc_2,                sizeof(_misc_2)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_LL_IPV6,  _ll_ipv6,               sizeof(_ll_ipv6)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_LL_IPV6_T,_ll_ipv6_tmp,           sizeof(_ll_ipv6_tmp)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_GLB_IPV6, _glb_ipv6,              sizeof(_glb_ipv6)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_V3_HASH,  _v3_hash,               sizeof(_v3_hash)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_SERVICE,  _service,               sizeof(_service)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_HDD_SER,  _hdd_ser,               sizeof(_hdd_ser)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_MISC_6,   NULL,                   0));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_MISC_7,   _misc_7,                sizeof(_misc_7)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_OS_BITS,  _os_bits,               sizeof(_os_bits)));
+    CHK_ADD(rjv3_props_append(props, RJV3_TYPE_VER_STR,  (uint8_t*)_ver_str,    strlen(_ver_str) + 1)); // Zero terminated
 
     return _len;
 }
@@ -337,8 +360,8 @@ static int rjv3_should_fill_dhcp_prop(struct _packet_plugin* this) {
             (PRIV->dhcp_type == DHCP_DOUBLE_AUTH && PRIV->succ_count >= 2);
 }
 
-/* The bytes containing twisted IPv4 addresses */
-static void rjv3_append_priv_header(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
+/* The bytes containing twisted IPv4 addresses, `buf` should hold sizeof(DHCP_INFO_PROP) bytes */
+static void rjv3_set_dhcp_prop(struct _packet_plugin* this, uint8_t* buf) {
     DHCP_INFO_PROP _dhcp_prop = {0};
 
     _dhcp_prop.magic[0] = 0x00;
@@ -355,20 +378,52 @@ static void rjv3_append_priv_header(struct _packet_plugin* this, ETH_EAP_FRAME*
     *(uint16_t*)&_dhcp_prop.crc16_hash = htons(crc16((uint8_t*)&_dhcp_prop, 21));
 
     rj_encode((uint8_t*)&_dhcp_prop, sizeof(_dhcp_prop));
-    append_to_frame(frame, (uint8_t*)&_dhcp_prop, sizeof(_dhcp_prop));
+    memmove(buf, &_dhcp_prop, sizeof(_dhcp_prop));
+}
+
+/* DHCP block, program name and version. Returns the length */
+static int rjv3_set_priv_header(struct _packet_plugin* this, uint8_t* buf) {
+    static const uint8_t _magic[4] = {0x00, 0x00, 0x13, 0x11};
+    static const uint8_t _prog_name[RJV3_SIZE_PROG_NAME] = RJV3_PROG_NAME;
+    static const uint8_t _version[4] = {0x01, 0x1f, 0x01, 0x02}; /* May be different */
+    int _len = 0;
 
-    uint8_t _magic[4] = {0x00, 0x00, 0x13, 0x11};
-    append_to_frame(frame, _magic, sizeof(_magic));
+    rjv3_set_dhcp_prop(this, buf);
+    _len += sizeof(DHCP_INFO_PROP);
 
-    uint8_t _prog_name[RJV3_SIZE_PROG_NAME] = RJV3_PROG_NAME;
-    append_to_frame(frame, _prog_name, sizeof(_prog_name));
+    memmove(buf + _len, _magic, sizeof(_magic));
+    _len += sizeof(_magic);
 
-    uint8_t _version[4] = {0x01, 0x1f, 0x01, 0x02}; /* May be different */
-    append_to_frame(frame, _version, sizeof(_version));
+    memmove(buf + _len, _prog_name, sizeof(_prog_name));
+    _len += sizeof(_prog_name);
+
+    memmove(buf + _len, _version, sizeof(_version));
+    _len += sizeof(_version);
+    return _len;
 }
 
-/* Append everything proprietary */
-RESULT rjv3_append_priv(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
+/*
+ * Offset of the content of prop `type` in the template, 0 if it should not be patched.
+ * `props_pos` is where `props` is serialized in the template.
+ */
+static int rjv3_locate_template_field(struct _packet_plugin* this, const RJV3_PROPS* props,
+                                      int props_pos, uint8_t type, int* content_len) {
+    RJ_PROP* _prop = rjv3_props_find(props, type);
+
+    /* Fixed by user */
+    if (_prop == NULL || rjv3_props_find(&PRIV->cmd_mod_props, type) != NULL) {
+        return 0;
+    }
+    if (content_len != NULL) {
+        *content_len = PROP_TO_CONTENT_SIZE(_prop);
+    }
+    return props_pos + (_prop->content - props->buf);
+}
+
+/*
+ * Build the props as usual, apply the mods and serialize everything
+ */
+static RESULT rjv3_build_template(struct _packet_plugin* this, RJV3_TEMPLATE* tpl, int append_pwd_hash) {
     /*
      * Size field, its format is NOT the same as those header1.magic == 0x1a ones.
      * Thus do not use the prop APIs.
@@ -380,117 +435,212 @@ RESULT rjv3_append_priv(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
             <other 0x1a fields follow>
         }
      */
-    int _props_len = 0, _single_len = 0;
-    uint8_t _std_prop_buf[FRAME_BUF_SIZE] = {0}; // Buffer for 0x1a props
-    LIST_ELEMENT* _prop_list = NULL;
+    /* logoffReason(1) magic(4) length(2) */
+    static const uint8_t _header[7] = {0x00, 0x00, 0x00, 0x13, 0x11, 0x00, 0x00};
+    int _header_pos, _props_pos, _common_len, _cmd_len, _props_len, _pwd_hash_len = 0;
+    RJV3_PROPS _props;
 
-    rjv3_apply_bcast_addr(this, frame);
-    rjv3_append_priv_header(this, frame);
+    tpl->len = 0;
+    tpl->dhcp_filled = rjv3_should_fill_dhcp_prop(this);
+    _header_pos = rjv3_set_priv_header(this, tpl->buf);
+    _props_pos = _header_pos + sizeof(_header);
+
+    rjv3_set_v3_pad_hash(tpl->v3_pad_hash);
 
     /* Let's make the big news! */
-    _single_len = rjv3_append_common_fields(this, &_prop_list, IS_MD5_FRAME(frame));
-    if (_single_len < 0) {
+    rjv3_props_init(&_props);
+    if (rjv3_append_common_fields(this, &_props, append_pwd_hash, tpl->v3_pad_hash) < 0) {
         return FAILURE;
     }
 
     /* The Mods! */
-    _props_len += modify_rjv3_prop_list(_prop_list, PRIV->cmd_prop_mod_list);
-
-    /* Actually read from sparse nodes into a unite buffer */
-    _single_len = append_rjv3_prop_list_to_buffer(_prop_list, _std_prop_buf, FRAME_BUF_SIZE);
+    rjv3_props_modify_all(&_props, &PRIV->cmd_mod_props);
 
-    if (_single_len > 0) {
-        _props_len += _single_len;
-    } else {
+    /* One copy for all */
+    _common_len = rjv3_props_to_buffer(&_props, tpl->buf + _props_pos, FRAME_BUF_SIZE - _props_pos);
+    if (_common_len <= 0) {
         return FAILURE;
     }
 
     /* And those from cmdline */
-    _single_len = append_rjv3_prop_list_to_buffer(PRIV->cmd_prop_list,
-                                                  _std_prop_buf + _props_len,
-                                                  FRAME_BUF_SIZE - _props_len);
-    if (_single_len >= 0) { // This time with '='
-        _props_len += _single_len;
-    } else {
+    _cmd_len = rjv3_props_to_buffer(&PRIV->cmd_props, tpl->buf + _props_pos + _common_len,
+                                    FRAME_BUF_SIZE - _props_pos - _common_len);
+    if (_cmd_len < 0) { // This time with '='
         return FAILURE;
     }
 
     /* The outside */
-    /* logoffReason(1) magic(4) length(2) */
-    uint8_t _header[7] = {0x00, 0x00, 0x00, 0x13, 0x11, 0x00, 0x00};
-    _header[5] = (_props_len >> 8 & 0xff);
-    _header[6] = (_props_len & 0xff);
+    _props_len = _common_len + _cmd_len;
+    memmove(tpl->buf + _header_pos, _header, sizeof(_header));
+    tpl->buf[_header_pos + 5] = (_props_len >> 8 & 0xff);
+    tpl->buf[_header_pos + 6] = (_props_len & 0xff);
+
+    /* Where to patch for later frames. Those from --rj-option are never patched */
+    tpl->pwd_hash_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_PWD_HASH, &_pwd_hash_len);
+    if (_pwd_hash_len != RJV3_SIZE_PWD_HASH) {
+        tpl->pwd_hash_pos = 0; /* Empty outside MD5-Challenge */
+    }
+    tpl->v3_hash_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_V3_HASH, NULL);
+    tpl->sec_dns_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_SEC_DNS, &tpl->sec_dns_len);
+    tpl->ll_ipv6_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_LL_IPV6, NULL);
+    tpl->ll_ipv6_t_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_LL_IPV6_T, NULL);
+    tpl->glb_ipv6_pos = rjv3_locate_template_field(this, &_props, _props_pos, RJV3_TYPE_GLB_IPV6, NULL);
+
+    tpl->len = _props_pos + _props_len;
+    return SUCCESS;
+}
 
-    append_to_frame(frame, _header, sizeof(_header));
+void rjv3_invalidate_templates(struct _packet_plugin* this) {
+    PRIV->templates[0].len = 0;
+    PRIV->templates[1].len = 0;
+}
 
-    append_to_frame(frame, _std_prop_buf, _props_len);
+/*
+ * Generations of the caches the addresses come from. If they are the same as
+ * when the template was last patched, so are the addresses.
+ */
+static void rjv3_get_generations(uint32_t* iface_gen, uint32_t* dns_gen) {
+    IF_IMPL* _if_impl = get_if_impl();
+    char _ifname[IFNAMSIZ] = {0};
 
-    destroy_rjv3_prop_list(&_prop_list);
-    return SUCCESS;
+    *iface_gen = 0;
+    if (_if_impl != NULL && !IS_FAIL(_if_impl->get_ifname(_if_impl, _ifname, IFNAMSIZ))) {
+        *iface_gen = iface_cache_generation(_ifname);
+    }
+    *dns_gen = dns_cache_generation();
 }
 
-static int rjv3_is_echokey_prop(void* unused, void* prop) {
-    RJ_PROP* _prop = (RJ_PROP*)prop;
+/*
+ * Append everything proprietary
+ *
+ * The fields are built and serialized only once per session (see RJV3_TEMPLATE).
+ * Each frame just patches the hashes into the template. The addresses and the
+ * DHCP block are looked up again only after the interface or resolv.conf changes.
+ */
+RESULT rjv3_append_priv(struct _packet_plugin* this, ETH_EAP_FRAME* frame) {
+    int _is_md5 = IS_MD5_FRAME(frame) ? 1 : 0;
+    RJV3_TEMPLATE* _tpl = &PRIV->templates[_is_md5];
+    char _sec_dns[INET6_ADDRSTRLEN] = {0};
+    uint32_t _iface_gen, _dns_gen;
+    int _addr_changed;
 
-    if (_prop->header2.type == 0x1 && PROP_TO_CONTENT_SIZE(_prop) != 0) {
-        return 0;
+    /* New session. MAC etc. may have changed */
+    if (frame->header->eapol_hdr.type[0] == EAPOL_START) {
+        rjv3_invalidate_templates(this);
+    }
+
+    /* Before the lookups, so changes in between are seen next time */
+    rjv3_get_generations(&_iface_gen, &_dns_gen);
+    _addr_changed = _iface_gen == 0 || _dns_gen == 0
+                    || _iface_gen != _tpl->iface_gen || _dns_gen != _tpl->dns_gen;
+
+    if (_tpl->len > 0 && _addr_changed && _tpl->sec_dns_pos) {
+        rjv3_set_secondary_dns(_sec_dns, PRIV->fake_dns2);
+        if (strlen(_sec_dns) != _tpl->sec_dns_len) {
+            _tpl->len = 0; /* Layout changed */
+        }
+    }
+
+    if (_tpl->len == 0) {
+        if (IS_FAIL(rjv3_build_template(this, _tpl, _is_md5))) {
+            return FAILURE;
+        }
+    } else {
+        if (_addr_changed || _tpl->dhcp_filled != rjv3_should_fill_dhcp_prop(this)) {
+            _tpl->dhcp_filled = rjv3_should_fill_dhcp_prop(this);
+            rjv3_set_dhcp_prop(this, _tpl->buf);
+        }
+        if (_tpl->pwd_hash_pos) {
+            memset(_tpl->buf + _tpl->pwd_hash_pos, 0, RJV3_SIZE_PWD_HASH);
+            rjv3_set_pwd_hash(_tpl->buf + _tpl->pwd_hash_pos, LAST_MD5_VALUE);
+        }
+        if (_tpl->v3_hash_pos) {
+            rjv3_set_v3_hash(_tpl->buf + _tpl->v3_hash_pos, LAST_MD5_VALUE, PRIV->md5_value_len,
+                             _tpl->v3_pad_hash);
+        }
+        if (_addr_changed && _tpl->sec_dns_pos) {
+            memmove(_tpl->buf + _tpl->sec_dns_pos, _sec_dns, _tpl->sec_dns_len);
+        }
+        if (_addr_changed && (_tpl->ll_ipv6_pos || _tpl->ll_ipv6_t_pos || _tpl->glb_ipv6_pos)) {
+            uint8_t _ll_ipv6[RJV3_SIZE_LL_IPV6] = {0};
+            uint8_t _ll_ipv6_tmp[RJV3_SIZE_LL_IPV6_T] = {0};
+            uint8_t _glb_ipv6[RJV3_SIZE_GLB_IPV6] = {0};
+
+            rjv3_set_ipv6_addr(_ll_ipv6, _ll_ipv6_tmp, _glb_ipv6);
+#define PATCH_IF_LOCATED(pos, val) \
+    if (_tpl->pos) { \
+        memmove(_tpl->buf + _tpl->pos, val, sizeof(val)); \
+    }
+            PATCH_IF_LOCATED(ll_ipv6_pos, _ll_ipv6);
+            PATCH_IF_LOCATED(ll_ipv6_t_pos, _ll_ipv6_tmp);
+            PATCH_IF_LOCATED(glb_ipv6_pos, _glb_ipv6);
+        }
     }
-    return 1;
+    _tpl->iface_gen = _iface_gen;
+    _tpl->dns_gen = _dns_gen;
+
+    rjv3_apply_bcast_addr(this, frame);
+    append_to_frame(frame, _tpl->buf, _tpl->len);
+    return SUCCESS;
 }
 
 RESULT rjv3_process_result_prop(ETH_EAP_FRAME* frame) {
-    LIST_ELEMENT* _srv_msg = NULL;
-    RJ_PROP* _msg = NULL;
+    RJV3_PROP_ITER _iter;
+    RJV3_PROP_VIEW _prop;
+    RJV3_PROP_VIEW _srv_msg = {0}, _acct_msg = {0}, _echokey_prop = {0};
+    int _first = TRUE;
 
     /* Success frames does not have EAP_HEADER.type,
      * and do not use EAP_HEADER.len since it once betrayed us
      */
-    parse_rjv3_buf_to_prop_list(&_srv_msg,
-                                frame->content + sizeof(FRAME_HEADER)
-                                    - sizeof(frame->header->eap_hdr.type),
-                                frame->actual_len - sizeof(FRAME_HEADER)
-                                    + sizeof(frame->header->eap_hdr.type),
-                                TRUE);
-
-    /* Assume this server message is the first property */
-    if (_srv_msg != NULL) {
-        _msg = (RJ_PROP*)_srv_msg->content;
-        int _content_len = _msg->header2.len - HEADER2_SIZE_NO_MAGIC(_msg);
-
-        if (_content_len != 0) {
-            PR_INFO("服务器通知：\n");
-            pr_info_gbk((char*)_msg->content, _content_len);
+    rjv3_prop_iter_init(&_iter,
+                        frame->content + sizeof(FRAME_HEADER)
+                            - sizeof(frame->header->eap_hdr.type),
+                        frame->actual_len - sizeof(FRAME_HEADER)
+                            + sizeof(frame->header->eap_hdr.type),
+                        TRUE);
+
+    /* All we need in one pass. Stop at malformed ones but keep what we have got */
+    while (rjv3_prop_iter_next(&_iter, &_prop) > 0) {
+        /* Assume this server message is the first property */
+        if (_first) {
+            _srv_msg = _prop;
+            _first = FALSE;
+        }
+        if (_prop.type == RJV3_TYPE_ACCOUNTING_MSG && _acct_msg.content == NULL) {
+            _acct_msg = _prop;
+        }
+        /* First type 0x1 prop with content */
+        if (_prop.type == 0x1 && _prop.len != 0 && _echokey_prop.content == NULL) {
+            _echokey_prop = _prop;
         }
     }
+
+    if (_srv_msg.len != 0) {
+        PR_INFO("服务器通知：\n");
+        pr_info_gbk((char*)_srv_msg.content, _srv_msg.len);
+    }
     if (frame->header->eapol_hdr.type[0] == EAP_PACKET &&
             frame->header->eap_hdr.code[0] == EAP_SUCCESS) {
-        _msg = find_rjv3_prop(_srv_msg, RJV3_TYPE_ACCOUNTING_MSG);
-        if (_msg != NULL) {
-            int _content_len = _msg->header2.len - HEADER2_SIZE_NO_MAGIC(_msg);
-
-            if (_content_len != 0) {
-                PR_INFO("计费通知：\n");
-                pr_info_gbk((char*)_msg->content, _content_len);
-            }
+        if (_acct_msg.len != 0) {
+            PR_INFO("计费通知：\n");
+            pr_info_gbk((char*)_acct_msg.content, _acct_msg.len);
         }
 
-        _msg = NULL;
-        _msg = (RJ_PROP*)lookup_data(_srv_msg, NULL, rjv3_is_echokey_prop);
-        if (_msg == NULL) {
+        if (_echokey_prop.content == NULL) {
             PR_ERR("无法找到 echo key 的位置，将不能进行心跳");
             return FAILURE;
         } else {
             uint32_t _echokey = 0;
-            _echokey |= bit_reverse(~*(_msg->content + 6)) << 24;
-            _echokey |= bit_reverse(~*(_msg->content + 7)) << 16;
-            _echokey |= bit_reverse(~*(_msg->content + 8)) << 8;
-            _echokey |= bit_reverse(~*(_msg->content + 9));
+            _echokey |= bit_reverse(~*(_echokey_prop.content + 6)) << 24;
+            _echokey |= bit_reverse(~*(_echokey_prop.content + 7)) << 16;
+            _echokey |= bit_reverse(~*(_echokey_prop.content + 8)) << 8;
+            _echokey |= bit_reverse(~*(_echokey_prop.content + 9));
             rjv3_set_keepalive_echokey(_echokey);
             rjv3_set_keepalive_echono(rand() & 0xffff);
             rjv3_set_keepalive_dest_mac(frame->header->eth_hdr.src_mac);
         }
     }
-    destroy_rjv3_prop_list(&_srv_msg);
     return SUCCESS;
 }
 
@@ -506,7 +656,7 @@ void rjv3_start_secondary_auth(void* vthis) {
         if (PRIV->dhcp_count > PRIV->max_dhcp_count) {
             rjv3_process_result_prop(PRIV->duplicated_packet); // Loads of texts
             free_frame(&PRIV->duplicated_packet); // Duplicated in process_success
-            schedule_alarm(1, rjv3_send_keepalive_timed, this);
+            rjv3_start_keepalive(this);
             PR_ERR("无法获取 IPv4 地址等信息，将不会进行第二次认证而直接开始心跳");
         } else {
             PR_WARN("DHCP 可能尚未完成，将继续等待……");
@@ -4,6 +4,7 @@
 #include "eth_frame.h"
 #include "packet_plugin.h"
 #include "linkedlist.h"
+#include "if_impl.h"
 
 #include <stdint.h>
 
@@ -38,6 +39,7 @@
 #define RJV3_SIZE_V3_HASH   0x80
 
 #define RJV3_PAD_SIZE 16
+#define RJV3_MD5_VALUE_MAX 0xff /* MD5-Value-Size is one byte */
 
 #define RJV3_TYPE_SERVICE   0x39 /* Service name in ASCII (GBK) */
 #define RJV3_SIZE_SERVICE   0x20 /* Fixed size char array, filled by 0 */
@@ -90,9 +92,24 @@ typedef struct _rj_prop_header2 {
 typedef struct _rj_prop {
     RJ_PROP_HEADER1 header1;
     RJ_PROP_HEADER2 header2;
-    uint8_t* content; /* Length is included in header */
+    uint8_t content[]; /* Length is included in header */
 } RJ_PROP;
 
+#define RJV3_PROPS_MAX_COUNT (FRAME_BUF_SIZE / sizeof(RJ_PROP))
+
+/*
+ * A set of props, stored back to back in wire format.
+ * All-zero memory is an empty set, so no initialization is needed for static/calloc'd ones.
+ * See packet_plugin_rjv3_prop.h for the methods.
+ */
+typedef struct _rjv3_props {
+    int len; /* Bytes used in buf */
+    int count;
+    uint16_t pos[RJV3_PROPS_MAX_COUNT]; /* Offset of each prop in buf */
+    uint8_t index[256]; /* 1 + number of the first prop of each type, 0 = none */
+    uint8_t buf[FRAME_BUF_SIZE];
+} RJV3_PROPS;
+
 typedef struct _dhcp_lease {
     uint8_t ip[4];
     uint8_t netmask[4];
@@ -107,6 +124,29 @@ typedef struct _dhcp_info_prop {
     uint8_t crc16_hash[2]; /* Network byte order */
 } DHCP_INFO_PROP;
 
+/*
+ * Everything rjv3_append_priv() appends, serialized once per session.
+ * Offsets point to the contents of fields that change from frame to frame,
+ * 0 = do not patch (absent, or overridden by --rj-option ...:r).
+ * The DHCP block is always at offset 0 and always patched.
+ */
+typedef struct _rjv3_template {
+    int len; /* 0 = not built */
+    int pwd_hash_pos;
+    int v3_hash_pos;
+    int sec_dns_pos;
+    int sec_dns_len;
+    int ll_ipv6_pos;
+    int ll_ipv6_t_pos;
+    int glb_ipv6_pos;
+    /* What the addresses in `buf` were looked up from, see iface_cache_generation() */
+    uint32_t iface_gen;
+    uint32_t dns_gen;
+    int dhcp_filled; /* DHCP block has the lease */
+    uint8_t v3_pad_hash[RJV3_SIZE_V3_HASH]; /* Outside MD5-Challenge it is always the same */
+    uint8_t buf[FRAME_BUF_SIZE];
+} RJV3_TEMPLATE;
+
 typedef struct _packet_plugin_rjv3_priv {
     struct { // Cmdline options
         int heartbeat_interval;
@@ -119,17 +159,24 @@ typedef struct _packet_plugin_rjv3_priv {
         char* fake_serial;
         DOT1X_BCAST_ADDR bcast_addr;
         DHCP_TYPE dhcp_type;
-        LIST_ELEMENT* cmd_prop_list; // Destroy!
-        LIST_ELEMENT* cmd_prop_mod_list; // Destroy!
+        RJV3_PROPS cmd_props; // Appended after the common ones
+        RJV3_PROPS cmd_mod_props; // Replacing the common ones
     };
     // Internal state variables
     int succ_count;
     int dhcp_count; // Used in double auth
-    ETH_EAP_FRAME* last_recv_packet;
+    int last_recv_md5; // Last frame received is MD5-Challenge, its MD5-Value is kept below
+    int md5_value_len;
+    uint8_t md5_value[RJV3_MD5_VALUE_MAX];
     ETH_EAP_FRAME* duplicated_packet; // Used in double auth
+    RJV3_TEMPLATE templates[2]; // Indexed by "is MD5-Challenge response"
+    uint8_t hdd_serial[RJV3_SIZE_HDD_SER]; // Read once
+    int hdd_serial_read;
 } rjv3_priv;
 
+void rjv3_save_last_recv(struct _packet_plugin* this, ETH_EAP_FRAME* frame);
 RESULT rjv3_append_priv(struct _packet_plugin* this, ETH_EAP_FRAME* frame);
+void rjv3_invalidate_templates(struct _packet_plugin* this);
 RESULT rjv3_process_result_prop(ETH_EAP_FRAME* frame);
 void rjv3_start_secondary_auth(void* vthis);
 #endif
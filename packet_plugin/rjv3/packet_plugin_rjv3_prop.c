@@ -1,6 +1,6 @@
-#include "linkedlist.h"
 #include "minieap_common.h"
 #include "packet_plugin_rjv3_priv.h"
+#include "packet_plugin_rjv3_prop.h"
 #include "misc.h"
 #include "logging.h"
 #include "eth_frame.h"
@@ -9,152 +9,122 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <string.h>
 
-RJ_PROP* new_rjv3_prop() {
-    RJ_PROP* _prop = (RJ_PROP*)malloc(sizeof(RJ_PROP));
-    if (_prop == NULL) {
-        PR_ERRNO("RJv3 字段结构内存分配失败");
-        return NULL;
+void rjv3_props_init(RJV3_PROPS* props) {
+    props->len = 0;
+    props->count = 0;
+    memset(props->index, 0, sizeof(props->index));
+}
+
+int rjv3_props_append(RJV3_PROPS* props, uint8_t type, const uint8_t* content, int len) {
+    RJ_PROP* _prop;
+
+    if (len > MAX_PROP_CONTENT_LEN) {
+        PR_DBG("类型为 0x%02hhx 的字段过长（%d 字节），已截断", type, len);
+        len = MAX_PROP_CONTENT_LEN;
+    } else if (len < 0) {
+        len = 0;
+    }
+    if (props->count >= RJV3_PROPS_MAX_COUNT
+            || props->len + sizeof(RJ_PROP) + len > sizeof(props->buf)) {
+        PR_ERR("缓冲空间不足，无法追加字段");
+        return -1;
     }
 
+    _prop = (RJ_PROP*)(props->buf + props->len);
     /* REAL MAGIC! */
     _prop->header1.header_type = 0x1a;
+    _prop->header1.header_len = len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2);
     _prop->header2.magic[0] = 0x00;
     _prop->header2.magic[1] = 0x00;
     _prop->header2.magic[2] = 0x13;
     _prop->header2.magic[3] = 0x11;
-    return _prop;
-}
-
-int append_rjv3_prop(LIST_ELEMENT** list, uint8_t type, uint8_t* content, int len) {
-    RJ_PROP* _prop = new_rjv3_prop();
-    if (_prop == NULL) return -1;
-
-    uint8_t* buf = NULL;
-    if (len > 0) {
-        buf = memdup(content, len);
-        if (buf == NULL) {
-            free(_prop);
-            return -1;
-        }
-    }
-
-    _prop->header1.header_len = len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2);
     _prop->header2.type = type;
     _prop->header2.len = len + HEADER2_SIZE_NO_MAGIC(_prop);
-    _prop->content = buf;
-    insert_data(list, _prop);
-    return _prop->header1.header_len;
-}
-
-/* Risky. Normally to_match and src should be the same type. */
-static int rjv3_type_prop_compare(void* to_match, void* src) {
-    if (((RJ_PROP*)src)->header2.type == *(uint8_t*)to_match)
-        return 0;
-    return 1;
-}
-
-int modify_rjv3_prop(LIST_ELEMENT* list, uint8_t type, uint8_t* content, int len) {
-    RJ_PROP* _prop = (RJ_PROP*)lookup_data(list, &type, rjv3_type_prop_compare);
-    if (_prop == NULL) return 0; // Nothing modified
-
-    uint8_t* buf = NULL;
     if (len > 0) {
-        buf = memdup(content, len);
-        if (buf == NULL) {
-            free(_prop);
-            return -1;
-        }
+        memmove(_prop->content, content, len);
     }
 
-    int _org_header2_len = _prop->header2.len;
-    chk_free((void**)&_prop->content);
-    _prop->content = buf;
-    _prop->header2.len = len + HEADER2_SIZE_NO_MAGIC(_prop);
-    _prop->header1.header_len = len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2);
-    return _prop->header2.len - _org_header2_len;
-}
-
-int modify_rjv3_prop_list(LIST_ELEMENT* org, LIST_ELEMENT* mods) {
-    LIST_ELEMENT* _curr;
-    int _delta = 0;
-    for (_curr = mods; _curr; _curr = _curr->next) {
-#define CURR ((RJ_PROP*)_curr->content)
-        _delta += modify_rjv3_prop(org,
-                                  CURR->header2.type,
-                                  CURR->content,
-                                  PROP_TO_CONTENT_SIZE(CURR));
+    props->pos[props->count++] = props->len;
+    if (props->index[type] == 0) {
+        props->index[type] = props->count; /* 1 + number of this one */
     }
-    return _delta;
+    props->len += sizeof(RJ_PROP) + len;
+    return sizeof(RJ_PROP) + len;
 }
 
-void remove_rjv3_prop(LIST_ELEMENT** list, uint8_t type) {
-    remove_data(list, &type, rjv3_type_prop_compare, TRUE);
+RJ_PROP* rjv3_props_find(const RJV3_PROPS* props, uint8_t type) {
+    if (props->index[type] == 0) {
+        return NULL;
+    }
+    return rjv3_props_at(props, props->index[type] - 1);
 }
 
-RJ_PROP* find_rjv3_prop(LIST_ELEMENT* list, uint8_t type) {
-    return (RJ_PROP*)lookup_data(list, &type, rjv3_type_prop_compare);
+RJ_PROP* rjv3_props_at(const RJV3_PROPS* props, int i) {
+    return (RJ_PROP*)(props->buf + props->pos[i]);
 }
 
-int append_rjv3_prop_to_buffer(RJ_PROP* prop, uint8_t* buf, int buflen) {
-    int _content_len = PROP_TO_CONTENT_SIZE(prop);
-    int _full_len = sizeof(RJ_PROP_HEADER1)+ sizeof(RJ_PROP_HEADER2) + _content_len;
+int rjv3_props_modify(RJV3_PROPS* props, uint8_t type, const uint8_t* content, int len) {
+    int _number, _org_len, _delta, _tail_pos, i;
+    RJ_PROP* _prop;
 
-    if (buflen < _full_len) {
-        PR_ERR("缓冲空间不足，无法追加字段");
-        return -1;
-    }
+    if (props->index[type] == 0) return 0; // Nothing modified
 
-    if (prop->header1.header_type != 0x1a) {
-        PR_WARN("不支持写入 header_type 为 %hhu 的字段", prop->header1.header_type);
-        return 0;
-    }
-    memmove(buf, &prop->header1, sizeof(RJ_PROP_HEADER1));
-    memmove(buf + sizeof(RJ_PROP_HEADER1), &prop->header2, sizeof(RJ_PROP_HEADER2));
-    if (_content_len > 0) {
-        memmove(buf + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2),
-                prop->content, _content_len);
+    if (len > MAX_PROP_CONTENT_LEN) {
+        len = MAX_PROP_CONTENT_LEN;
     }
-    return _full_len;
-}
 
-int append_rjv3_prop_list_to_buffer(LIST_ELEMENT* list, uint8_t* buf, int buflen) {
-    size_t _props_len = 0, _single_len = 0;
-    LIST_ELEMENT* _curr;
+    _number = props->index[type] - 1;
+    _prop = rjv3_props_at(props, _number);
+    _org_len = PROP_TO_CONTENT_SIZE(_prop);
+    _delta = len - _org_len;
 
-    for (_curr = list; _curr; _curr = _curr->next) {
-        _single_len = append_rjv3_prop_to_buffer((RJ_PROP*)_curr->content,
-                                                 buf + _props_len,
-                                                 buflen - _props_len);
-        if (_single_len > 0) {
-            _props_len += _single_len;
-        } else {
-            return -1;
+    if (_delta != 0) {
+        /* Move everything after this one */
+        if (props->len + _delta > sizeof(props->buf)) {
+            PR_ERR("缓冲空间不足，无法修改字段");
+            return 0;
+        }
+        _tail_pos = props->pos[_number] + sizeof(RJ_PROP) + _org_len;
+        memmove(props->buf + _tail_pos + _delta, props->buf + _tail_pos, props->len - _tail_pos);
+        for (i = _number + 1; i < props->count; ++i) {
+            props->pos[i] += _delta;
         }
+        props->len += _delta;
     }
 
-    return _props_len;
+    if (len > 0) {
+        memmove(_prop->content, content, len);
+    }
+    _prop->header2.len = len + HEADER2_SIZE_NO_MAGIC(_prop);
+    _prop->header1.header_len = len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2);
+    return _delta;
 }
 
-/* This one utilizes packet_util, thus no need to mess with pointer arithmetics */
-void append_rjv3_prop_to_frame(RJ_PROP* prop, ETH_EAP_FRAME* frame) {
-    int _content_len = 0;
-    if (prop->header1.header_type == 0x1a) {
-        _content_len = PROP_TO_CONTENT_SIZE(prop);
-    } else if (prop->header1.header_type == 0x02) {
-        /* Container prop, see `rjv3_prepare_frame` */
-        _content_len = prop->header2.len + (prop->header2.type << 8);
-    } else {
-        PR_WARN("不支持写入 header_type 为 %hhu 的字段", prop->header1.header_type);
-        return;
+int rjv3_props_modify_all(RJV3_PROPS* props, const RJV3_PROPS* mods) {
+    RJ_PROP* _mod;
+    int _delta = 0, i;
+    for (i = 0; i < mods->count; ++i) {
+        _mod = rjv3_props_at(mods, i);
+        _delta += rjv3_props_modify(props,
+                                    _mod->header2.type,
+                                    _mod->content,
+                                    PROP_TO_CONTENT_SIZE(_mod));
     }
+    return _delta;
+}
 
-    append_to_frame(frame, (uint8_t*)&prop->header1, sizeof(RJ_PROP_HEADER1));
-    append_to_frame(frame, (uint8_t*)&prop->header2, sizeof(RJ_PROP_HEADER2));
-    append_to_frame(frame, prop->content, _content_len);
+int rjv3_props_to_buffer(const RJV3_PROPS* props, uint8_t* buf, int buflen) {
+    if (buflen < props->len) {
+        PR_ERR("缓冲空间不足，无法追加字段");
+        return -1;
+    }
+    memmove(buf, props->buf, props->len);
+    return props->len;
 }
 
-static uint8_t* find_byte_pattern(uint8_t* pattern, int patlen, uint8_t* buf, int buflen) {
+static const uint8_t* find_byte_pattern(const uint8_t* pattern, int patlen, const uint8_t* buf, int buflen) {
     int _read_len = 0;
     while (_read_len + patlen < buflen) {
         if (memcmp(pattern, buf + _read_len, patlen) == 0) {
@@ -184,89 +154,82 @@ static inline int rjv3_prop_length_field_ok(RJ_PROP *prop) {
     return 1;
 }
 
-RESULT parse_rjv3_buf_to_prop_list(LIST_ELEMENT** list, uint8_t* buf, int buflen, int bare /* buf_has_header1 ? */) {
-    int _read_len = 0, _content_len = 0;
-    uint8_t _magic[] = {0x00, 0x00, 0x13, 0x11};
-    RJ_PROP* _tmp_prop = new_rjv3_prop();
-    if (_tmp_prop == NULL) return FAILURE;
-
-    if (bare) {
-        while (_read_len < buflen) {
-            if (_read_len + sizeof(RJ_PROP_HEADER2) > buflen) {
-                return FAILURE; /* Incomplete buf */
-            }
-
-            memmove(&_tmp_prop->header2, buf + _read_len, sizeof(RJ_PROP_HEADER2));
-            _read_len += sizeof(RJ_PROP_HEADER2);
-
-            if (memcmp(_tmp_prop->header2.magic, _magic, sizeof(_magic)) == 0) {
-                /* Valid */
-                if (rjv3_prop_length_field_ok(_tmp_prop)) {
-                    _content_len = _tmp_prop->header2.len - sizeof(RJ_PROP_HEADER2) + sizeof(_tmp_prop->header2.magic);
-                } else {
-                    uint8_t* _next_magic = find_byte_pattern(_magic, sizeof(_magic),
-                                                              buf + _read_len, buflen - _read_len);
-                    _content_len = _next_magic ? (_next_magic - (buf + _read_len)) : buflen - _read_len;
-                }
-
-                append_rjv3_prop(list,
-                                 _tmp_prop->header2.type,
-                                 buf + _read_len,
-                                 _content_len);
-                _read_len += _content_len;
-            } else {
-                PR_DBG("字段格式错误，未发现特征值（偏移量 0x%x）", _read_len);
-                goto err;
-            }
+void rjv3_prop_iter_init(RJV3_PROP_ITER* iter, const uint8_t* buf, int buflen, int bare /* buf_has_header1 ? */) {
+    iter->buf = buf;
+    iter->buflen = buflen;
+    iter->pos = 0;
+    iter->bare = bare;
+}
+
+int rjv3_prop_iter_next(RJV3_PROP_ITER* iter, RJV3_PROP_VIEW* view) {
+    static const uint8_t _magic[] = {0x00, 0x00, 0x13, 0x11};
+    const uint8_t* _buf = iter->buf;
+    int _read_len = iter->pos, _buflen = iter->buflen, _content_len;
+    RJ_PROP _tmp_prop;
+
+    if (_read_len >= _buflen) {
+        return 0;
+    }
+
+    if (iter->bare) {
+        if (_read_len + sizeof(RJ_PROP_HEADER2) > _buflen) {
+            return -1; /* Incomplete buf */
         }
     } else {
-        while (_read_len < buflen) {
-            if (_read_len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2) > buflen) {
-                return FAILURE; /* Incomplete buf */
-            }
-
-            memmove(&_tmp_prop->header1, buf + _read_len, sizeof(RJ_PROP_HEADER1));
-            _read_len += sizeof(RJ_PROP_HEADER1);
-            memmove(&_tmp_prop->header2, buf + _read_len, sizeof(RJ_PROP_HEADER2));
-            _read_len += sizeof(RJ_PROP_HEADER2);
-
-            if (memcmp(_tmp_prop->header2.magic, _magic, sizeof(_magic)) == 0) {
-                /* Valid */
-                if (_tmp_prop->header1.header_type == 0x1a) {
-                    _content_len = PROP_TO_CONTENT_SIZE(_tmp_prop);
-                } else {
-                    uint8_t* _next_magic = find_byte_pattern(_magic, sizeof(_magic),
-                                                              buf + _read_len, buflen - _read_len);
-                    _content_len = _next_magic ? (_next_magic - (buf + _read_len) - sizeof(RJ_PROP_HEADER1))
-                                               : buflen - _read_len;
-                    PR_WARN("解析数据包时发现未知 header_type: %hhu", _tmp_prop->header1.header_type);
-                }
-
-                append_rjv3_prop(list,
-                                 _tmp_prop->header2.type,
-                                 buf + _read_len,
-                                 _content_len);
-                _read_len += _content_len;
-            } else {
-                PR_DBG("字段格式错误，未发现特征值（偏移量 0x%x）", _read_len);
-                goto err;
-            }
+        if (_read_len + sizeof(RJ_PROP_HEADER1) + sizeof(RJ_PROP_HEADER2) > _buflen) {
+            return -1; /* Incomplete buf */
         }
+
+        memmove(&_tmp_prop.header1, _buf + _read_len, sizeof(RJ_PROP_HEADER1));
+        _read_len += sizeof(RJ_PROP_HEADER1);
     }
+    memmove(&_tmp_prop.header2, _buf + _read_len, sizeof(RJ_PROP_HEADER2));
+    _read_len += sizeof(RJ_PROP_HEADER2);
 
-    free(_tmp_prop);
-    return SUCCESS;
+    if (memcmp(_tmp_prop.header2.magic, _magic, sizeof(_magic)) != 0) {
+        PR_DBG("字段格式错误，未发现特征值（偏移量 0x%x）", _read_len);
+        return -1;
+    }
 
-err:
-    free(_tmp_prop);
-    return FAILURE;
-}
+    /* Valid */
+    if (iter->bare ? rjv3_prop_length_field_ok(&_tmp_prop) : _tmp_prop.header1.header_type == 0x1a) {
+        _content_len = PROP_TO_CONTENT_SIZE((&_tmp_prop));
+    } else {
+        const uint8_t* _next_magic = find_byte_pattern(_magic, sizeof(_magic),
+                                                        _buf + _read_len, _buflen - _read_len);
+        if (iter->bare) {
+            _content_len = _next_magic ? (_next_magic - (_buf + _read_len)) : _buflen - _read_len;
+        } else {
+            _content_len = _next_magic ? (_next_magic - (_buf + _read_len) - sizeof(RJ_PROP_HEADER1))
+                                       : _buflen - _read_len;
+            PR_WARN("解析数据包时发现未知 header_type: %hhu", _tmp_prop.header1.header_type);
+        }
+    }
 
-static void free_content(void* elem, void* unused) {
-    free(((RJ_PROP*)elem)->content);
+    if (_content_len < 0 || _read_len + _content_len > _buflen) {
+        PR_DBG("类型为 0x%02hhx 的字段长度超出缓冲区", _tmp_prop.header2.type);
+        return -1;
+    }
+
+    view->type = _tmp_prop.header2.type;
+    view->content = _buf + _read_len;
+    view->len = _content_len;
+    iter->pos = _read_len + _content_len;
+    return 1;
 }
 
-void destroy_rjv3_prop_list(LIST_ELEMENT** list) {
-    list_traverse(*list, free_content, NULL);
-    list_destroy(list, TRUE);
+RESULT rjv3_props_parse(RJV3_PROPS* props, const uint8_t* buf, int buflen, int bare) {
+    RJV3_PROP_ITER _iter;
+    RJV3_PROP_VIEW _view;
+    int _ret;
+
+    rjv3_props_init(props);
+    rjv3_prop_iter_init(&_iter, buf, buflen, bare);
+    while ((_ret = rjv3_prop_iter_next(&_iter, &_view)) > 0) {
+        if (rjv3_props_append(props, _view.type, _view.content, _view.len) < 0) {
+            return FAILURE;
+        }
+    }
+
+    return _ret == 0 ? SUCCESS : FAILURE;
 }
@@ -2,63 +2,100 @@
 #define _MINIEAP_PACKET_PLUGIN_RJV3_PROP_H
 
 #include "packet_plugin_rjv3_priv.h"
-#include "linkedlist.h"
 #include "minieap_common.h"
 
 #include <stdint.h>
 
 #define MAX_PROP_LEN 200 // Assumed
+#define MAX_PROP_CONTENT_LEN 0xfd // What header2.len can hold
 
 /*
- * CRUD methods for lists
+ * CRUD methods for prop sets (RJV3_PROPS)
  *
- * All `header_type` can be set to 0xFF to ignore, except `insert_rjv3_prop`.
+ * Props live in one buffer inside the set, there is no malloc anywhere.
+ * Append/find/in-place modify are O(1). Modifying to a different length moves
+ * the props after it, which is bounded by the buffer size.
  *
  * All `int` returning value means how many bytes the prop consists of.
+ * All these methods assume header_type == 0x1a
  */
 
 /*
- * `append_rjv3_prop` does not check if there is an existing field with same type/header_type,
- * thus may lead to duplicated entries.
- *
- * `append_rjv3_prop` will create a new buffer of content. This buffer should be freed
- * by destroying the list.
+ * Make the set empty
+ */
+void rjv3_props_init(RJV3_PROPS* props);
+
+/*
+ * `rjv3_props_append` does not check if there is an existing field with same type,
+ * thus may lead to duplicated entries. Finding/modifying only affects the first one.
  *
- * `modify_rjv3_prop[_list]` returns the difference in sizes of the field (new - old)
+ * Contents longer than MAX_PROP_CONTENT_LEN are truncated.
  *
- * All these methods assume header_type == 0x1a
+ * Return: -1 if there is no space left
+ */
+int rjv3_props_append(RJV3_PROPS* props, uint8_t type, const uint8_t* content, int len);
+
+/*
+ * Return: the difference in sizes of the field (new - old), 0 if not found
+ */
+int rjv3_props_modify(RJV3_PROPS* props, uint8_t type, const uint8_t* content, int len);
+
+/*
+ * Replace the contents of props in `props` with those of same types in `mods`
  */
-int append_rjv3_prop(LIST_ELEMENT** list, uint8_t type, uint8_t* content, int len);
-int modify_rjv3_prop(LIST_ELEMENT* list, uint8_t type, uint8_t* content, int len);
-int modify_rjv3_prop_list(LIST_ELEMENT* org, LIST_ELEMENT* mods);
-void remove_rjv3_prop(LIST_ELEMENT** list, uint8_t type);
+int rjv3_props_modify_all(RJV3_PROPS* props, const RJV3_PROPS* mods);
 
 /*
  * Find prop by type
  *
  * NULL if not found
  */
-RJ_PROP* find_rjv3_prop(LIST_ELEMENT* list, uint8_t type);
+RJ_PROP* rjv3_props_find(const RJV3_PROPS* props, uint8_t type);
+
 /*
- * Default header_type = 0x1a
+ * The `i`th prop, in the order of appending
  */
-RJ_PROP* new_rjv3_prop();
+RJ_PROP* rjv3_props_at(const RJV3_PROPS* props, int i);
 
 /*
- * Appending
+ * Write all props to `buf`
  *
- * `append_rjv3_prop_[list_]to_buffer` returns the number of actual bytes written
- * `append_rjv3_prop_to_frame` can be used in list_traverse so it has two void* params.
+ * Return: the number of actual bytes written, -1 if `buf` is too small
  */
-int append_rjv3_prop_to_buffer(RJ_PROP* prop, uint8_t* buf, int buflen);
-int append_rjv3_prop_list_to_buffer(LIST_ELEMENT* list, uint8_t* buf, int buflen);
-void append_rjv3_prop_to_frame(RJ_PROP* prop, ETH_EAP_FRAME* frame);
-void destroy_rjv3_prop_list(LIST_ELEMENT** list);
+int rjv3_props_to_buffer(const RJV3_PROPS* props, uint8_t* buf, int buflen);
 
 /*
- * Read all props in buffer and form a list of the props.
+ * Read all props in buffer into `props`. Previous contents of `props` are discarded.
  *
  * Make sure buf starts with xx xx 00 00 13 11 (normal) or 00 00 13 11 (bare)
  */
-RESULT parse_rjv3_buf_to_prop_list(LIST_ELEMENT** list, uint8_t* buf, int buflen, int bare);
+RESULT rjv3_props_parse(RJV3_PROPS* props, const uint8_t* buf, int buflen, int bare);
+
+/*
+ * Read-only walk over props in a received buffer, without copying anything.
+ * Views point into the buffer, so they are only valid as long as the buffer is.
+ */
+typedef struct _rjv3_prop_view {
+    uint8_t type;
+    const uint8_t* content;
+    int len; /* Content length */
+} RJV3_PROP_VIEW;
+
+typedef struct _rjv3_prop_iter {
+    const uint8_t* buf;
+    int buflen;
+    int pos; /* Where the next prop starts */
+    int bare; /* Props have no header1 */
+} RJV3_PROP_ITER;
+
+/*
+ * Same buffer requirements as rjv3_props_parse
+ */
+void rjv3_prop_iter_init(RJV3_PROP_ITER* iter, const uint8_t* buf, int buflen, int bare);
+
+/*
+ * Return: 1 if `view` is filled with the next prop, 0 at the end of buffer,
+ *         -1 if the rest of buffer is malformed
+ */
+int rjv3_prop_iter_next(RJV3_PROP_ITER* iter, RJV3_PROP_VIEW* view);
 #endif
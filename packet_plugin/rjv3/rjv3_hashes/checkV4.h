@@ -1,6 +1,16 @@
 #ifndef CHECKV4_H
 #define CHECKV4_H
 
+/*
+ * The `_r` ones write to caller's buffer and are reentrant.
+ * `buf` of computeV4_r holds 128 bytes (ASCII, not NUL-terminated),
+ * and that of computePwd_r holds 16 bytes. They return `buf`, or NULL on error.
+ *
+ * The others return a static buffer shared by all callers.
+ */
+unsigned char *computeV4_r(const unsigned char *src, int len, unsigned char *buf);
+char *computePwd_r(const unsigned char *md5, const char* username, const char* password, char *buf);
+
 unsigned char *computeV4(const unsigned char *src, int len);
 char *computePwd(const unsigned char *md5, const char* username, const char* password);
 #endif
@@ -45,7 +45,7 @@ void rhash_whirlpool_init(struct whirlpool_ctx* ctx)
 }
 
 /* Algorithm S-Box */
-extern uint64_t rhash_whirlpool_sbox[8][256];
+extern const uint64_t rhash_whirlpool_sbox[8][256];
 
 #define WHIRLPOOL_OP(src, shift) ( \
 	rhash_whirlpool_sbox[0][(int)(src[ shift      & 7] >> 56)       ] ^ \
@@ -57,83 +57,158 @@ extern uint64_t rhash_whirlpool_sbox[8][256];
 	rhash_whirlpool_sbox[6][(int)(src[(shift + 2) & 7] >>  8) & 0xff] ^ \
 	rhash_whirlpool_sbox[7][(int)(src[(shift + 1) & 7]      ) & 0xff])
 
+/* array used in the rounds */
+static const uint64_t rc[10] = {
+	I64(0x1823c6e887b8014f),
+	I64(0x36a6d2f5796f9152),
+	I64(0x60bc9b8ea30c7b35),
+	I64(0x1de0d7c22e4bfe57),
+	I64(0x157737e59ff04ada),
+	I64(0x58c9290ab1a06b85),
+	I64(0xbd5d10f4cb3e0567),
+	I64(0xe427418ba77d95d8),
+	I64(0xfbee7c66dd17479e),
+	I64(0xca2dbf07ad5a8333)
+};
+
+/*
+ * K^1 ... K^10 when K^0 is the initial hash value set in rhash_whirlpool_init.
+ * The key schedule only depends on the hash state, so it's constant for the
+ * first block of every message. Generated with the round function below.
+ */
+static const uint64_t rhash_whirlpool_iv_key_schedule[10][8] = {
+	{
+		I64(0xc0ec1e13b86f0a97), I64(0x889288413277e188),
+		I64(0xf677f696a98b48f6), I64(0x13c413edff5cd613),
+		I64(0x7f697faa3e84fd7f), I64(0xb76eb7a4f1093bb7),
+		I64(0x314c31e05518f921), I64(0x28282828282a2828)
+	},
+	{
+		I64(0x749f8f8141f9ecba), I64(0xf9e117040e022d5a),
+		I64(0x42e5fb71397542f5), I64(0x3b5be70d1933376b),
+		I64(0x24d3aea43535bc81), I64(0x5a1fa65ed9cf38ee),
+		I64(0x3949b042aeace549), I64(0x8573ccd30e40de88)
+	},
+	{
+		I64(0xc232365b3ab9284a), I64(0x201018d9f448ff68),
+		I64(0xc904c575713998e1), I64(0x7f4fcab96772870f),
+		I64(0x37481c07e501a466), I64(0xf421be9a72c9b2c7),
+		I64(0x92c5c9447892602f), I64(0xe49cd83ef0053586)
+	},
+	{
+		I64(0x08acb3c969083d96), I64(0xc0032f90306d88d8),
+		I64(0x4b8a62cac96b2771), I64(0x989d0714d7bbf02e),
+		I64(0x94698b53325ab89b), I64(0xcc1dde4f12bbf11b),
+		I64(0x48f49ef00ea85463), I64(0xfec2a97a6b2e6f55)
+	},
+	{
+		I64(0xc4bd0d1d7f02e955), I64(0xa32e5bfea40fa918),
+		I64(0x6ef12ea4c7b47113), I64(0x77902eb77c2e34c5),
+		I64(0xb24a118c38046502), I64(0xf833d3f3440fa26c),
+		I64(0xffc78e1e8802b84c), I64(0x31b97daed9982592)
+	},
+	{
+		I64(0x93a13efdebefce1a), I64(0x74f2d9d76eedc876),
+		I64(0x525409456d2990f5), I64(0xfd8640d9c8695c9f),
+		I64(0xf6baf5662d709023), I64(0x7854d5d14674ee6c),
+		I64(0x1c5d4ed13fae97c9), I64(0x96ac8bb36e6c2ebd)
+	},
+	{
+		I64(0xbfc021770a54bc4b), I64(0xac80042b7a58ea42),
+		I64(0x813add73efa77b4e), I64(0x2b15e1ee637ca715),
+		I64(0x3c5c502c2f2c465b), I64(0xc356771831cab2ae),
+		I64(0x9d30aed67b9f16cb), I64(0xd17baecab5c27330)
+	},
+	{
+		I64(0x4825b9f20e368c52), I64(0x0b14a1a044304564),
+		I64(0x94cc0aa736dbd203), I64(0x93a9f687cc18b2ee),
+		I64(0x1a8c0f508144eace), I64(0xf55972fc12a819db),
+		I64(0xc9440aab66aa9fca), I64(0xcc55cc1800df2832)
+	},
+	{
+		I64(0x18dfce6f2154ebc6), I64(0x8ce0b79fab4dfd90),
+		I64(0x33115b20d660bc69), I64(0x9d798567decb8907),
+		I64(0xc92f0826f17a6f74), I64(0xb83da793fc0f9bc9),
+		I64(0x5c139fcf7f87ce00), I64(0xc4ff0adb464783c0)
+	},
+	{
+		I64(0x8b34123add46b34e), I64(0x76af41d24e95c978),
+		I64(0x85525aead6b3a093), I64(0xfa986c60f31f297c),
+		I64(0x3a05f0208a23af15), I64(0xbc9f6c6be200e320),
+		I64(0x428507195194171e), I64(0x1b8ec7ad8b7e1638)
+	}
+};
+
+/* K^{i+1} from K^i */
+#define WHIRLPOOL_KEY_ROUND(dst, src, i) \
+	dst[0] = WHIRLPOOL_OP(src, 0) ^ rc[i]; \
+	dst[1] = WHIRLPOOL_OP(src, 1); \
+	dst[2] = WHIRLPOOL_OP(src, 2); \
+	dst[3] = WHIRLPOOL_OP(src, 3); \
+	dst[4] = WHIRLPOOL_OP(src, 4); \
+	dst[5] = WHIRLPOOL_OP(src, 5); \
+	dst[6] = WHIRLPOOL_OP(src, 6); \
+	dst[7] = WHIRLPOOL_OP(src, 7);
+
+/* The round transformation with round key `key`. Note the "+ 1"s, which are not in standard Whirlpool */
+#define WHIRLPOOL_STATE_ROUND(dst, src, key) \
+	dst[0] =  WHIRLPOOL_OP(src, 0) ^ key[0]; \
+	dst[1] =  WHIRLPOOL_OP(src, 1) ^ key[1]; \
+	dst[2] = (WHIRLPOOL_OP(src, 2) ^ key[2]) + 1; \
+	dst[3] =  WHIRLPOOL_OP(src, 3) ^ key[3]; \
+	dst[4] =  WHIRLPOOL_OP(src, 4) ^ key[4]; \
+	dst[5] = (WHIRLPOOL_OP(src, 5) ^ key[5]) + 1; \
+	dst[6] = (WHIRLPOOL_OP(src, 6) ^ key[6]) + 1; \
+	dst[7] =  WHIRLPOOL_OP(src, 7) ^ key[7];
+
 /**
  * The core transformation. Process a 512-bit block.
  *
+ * Two rounds are done per iteration, so the state and key ping-pong
+ * between fixed arrays, which the compiler can keep in registers.
+ *
  * @param hash algorithm state
  * @param block the message block to process
+ * @param is_first_block whether `hash` is still the initial value
  */
-static void rhash_whirlpool_process_block(uint64_t *hash, uint64_t* p_block)
+static void rhash_whirlpool_process_block(uint64_t *hash, uint64_t* p_block, int is_first_block)
 {
 	int i;                /* loop counter */
-	uint64_t K[2][8];       /* key */
-	uint64_t state[2][8];   /* state */
-
-	/* alternating binary flags */
-	unsigned int m = 0;
-
-	/* the number of rounds of the internal dedicated block cipher */
-	const int number_of_rounds = 10;
-
-	/* array used in the rounds */
-	static const uint64_t rc[10] = {
-		I64(0x1823c6e887b8014f),
-		I64(0x36a6d2f5796f9152),
-		I64(0x60bc9b8ea30c7b35),
-		I64(0x1de0d7c22e4bfe57),
-		I64(0x157737e59ff04ada),
-		I64(0x58c9290ab1a06b85),
-		I64(0xbd5d10f4cb3e0567),
-		I64(0xe427418ba77d95d8),
-		I64(0xfbee7c66dd17479e),
-		I64(0xca2dbf07ad5a8333)
-	};
+	uint64_t K0[8], K1[8];   /* key */
+	uint64_t S0[8], S1[8];   /* state */
 
 	/* map the message buffer to a block */
 	for (i = 0; i < 8; i++) {
 		/* store K^0 and xor it with the intermediate hash state */
-		K[0][i] = hash[i]; /***********maybe k[0][8-i]**************/
-		state[0][i] = be2me_64(p_block[i]) ^ hash[i]; /****maybe state[0][8-i]****/
-		hash[i] = state[0][i]; /**************maybe disapeared********/
+		K0[i] = hash[i];
+		S0[i] = be2me_64(p_block[i]) ^ hash[i];
+		hash[i] = S0[i];
 	}
 
-
 	/* iterate over algorithm rounds */
-	for (i = 0; i < number_of_rounds; i++)
-	{
-		/* compute K^i from K^{i-1} */
-		K[m ^ 1][0] = WHIRLPOOL_OP(K[m], 0) ^ rc[i];
-		K[m ^ 1][1] = WHIRLPOOL_OP(K[m], 1);
-		K[m ^ 1][2] = WHIRLPOOL_OP(K[m], 2);
-		K[m ^ 1][3] = WHIRLPOOL_OP(K[m], 3);
-		K[m ^ 1][4] = WHIRLPOOL_OP(K[m], 4);
-		K[m ^ 1][5] = WHIRLPOOL_OP(K[m], 5);
-		K[m ^ 1][6] = WHIRLPOOL_OP(K[m], 6);
-		K[m ^ 1][7] = WHIRLPOOL_OP(K[m], 7);
-
-		/* apply the i-th round transformation */
-		//state[m ^ 1][0] = WHIRLPOOL_OP(state[m], 0) ^ K[m ^ 1][0];
-		state[m ^ 1][0] = WHIRLPOOL_OP(state[m], 0) ^ K[m ^ 1][0];
-		state[m ^ 1][1] = (WHIRLPOOL_OP(state[m], 1) ^ K[m ^ 1][1]);
-		state[m ^ 1][2] = (WHIRLPOOL_OP(state[m], 2) ^ K[m ^ 1][2]) + 1;
-		state[m ^ 1][3] = (WHIRLPOOL_OP(state[m], 3) ^ K[m ^ 1][3]);
-		state[m ^ 1][4] = (WHIRLPOOL_OP(state[m], 4) ^ K[m ^ 1][4]);
-		state[m ^ 1][5] = (WHIRLPOOL_OP(state[m], 5) ^ K[m ^ 1][5]) + 1;
-		state[m ^ 1][6] = (WHIRLPOOL_OP(state[m], 6) ^ K[m ^ 1][6]) + 1;
-		state[m ^ 1][7] = (WHIRLPOOL_OP(state[m], 7) ^ K[m ^ 1][7]);
-
-		m = m ^ 1;
+	if (is_first_block) {
+		for (i = 0; i < 10; i += 2) {
+			WHIRLPOOL_STATE_ROUND(S1, S0, rhash_whirlpool_iv_key_schedule[i]);
+			WHIRLPOOL_STATE_ROUND(S0, S1, rhash_whirlpool_iv_key_schedule[i + 1]);
+		}
+	} else {
+		for (i = 0; i < 10; i += 2) {
+			WHIRLPOOL_KEY_ROUND(K1, K0, i);
+			WHIRLPOOL_STATE_ROUND(S1, S0, K1);
+			WHIRLPOOL_KEY_ROUND(K0, K1, i + 1);
+			WHIRLPOOL_STATE_ROUND(S0, S1, K0);
+		}
 	}
 
 	/* apply the Miyaguchi-Preneel compression function */
-	hash[0] ^= state[0][0];
-	hash[1] ^= state[0][1];
-	hash[2] ^= state[0][2];
-	hash[3] ^= state[0][3];
-	hash[4] ^= state[0][4];
-	hash[5] ^= state[0][5];
-	hash[6] ^= state[0][6];
-	hash[7] ^= state[0][7];
+	hash[0] ^= S0[0];
+	hash[1] ^= S0[1];
+	hash[2] ^= S0[2];
+	hash[3] ^= S0[3];
+	hash[4] ^= S0[4];
+	hash[5] ^= S0[5];
+	hash[6] ^= S0[6];
+	hash[7] ^= S0[7];
 }
 
 /**
@@ -148,6 +223,8 @@ void rhash_whirlpool_update(whirlpool_ctx *ctx, const unsigned char* msg, size_t
 {
 	unsigned index = (unsigned)ctx->length & 63;
 	unsigned left;
+	/* the first block is the one when no block was processed before */
+	int is_first_block = ctx->length < whirlpool_block_size;
 	ctx->length += size;
 
 	/* fill partial block */
@@ -157,7 +234,8 @@ void rhash_whirlpool_update(whirlpool_ctx *ctx, const unsigned char* msg, size_t
 		if (size < left) return;
 
 		/* process partial block */
-		rhash_whirlpool_process_block(ctx->hash, (uint64_t*)ctx->message);
+		rhash_whirlpool_process_block(ctx->hash, (uint64_t*)ctx->message, is_first_block);
+		is_first_block = 0;
 		msg  += left;
 		size -= left;
 	}
@@ -172,7 +250,8 @@ void rhash_whirlpool_update(whirlpool_ctx *ctx, const unsigned char* msg, size_t
 			aligned_message_block = (uint64_t*)ctx->message;
 		}
 
-		rhash_whirlpool_process_block(ctx->hash, aligned_message_block);
+		rhash_whirlpool_process_block(ctx->hash, aligned_message_block, is_first_block);
+		is_first_block = 0;
 		msg += whirlpool_block_size;
 		size -= whirlpool_block_size;
 	}
@@ -192,6 +271,7 @@ void rhash_whirlpool_final(whirlpool_ctx *ctx, unsigned char* result)
 {
 	unsigned index = (unsigned)ctx->length & 63;
 	uint64_t* msg64 = (uint64_t*)ctx->message;
+	int is_first_block = ctx->length < whirlpool_block_size;
 
 	/* pad message and run for last block */
 	ctx->message[index++] = 0x80;
@@ -202,7 +282,8 @@ void rhash_whirlpool_final(whirlpool_ctx *ctx, unsigned char* result)
 		while (index < 64) {
 			ctx->message[index++] = 0;
 		}
-		rhash_whirlpool_process_block(ctx->hash, msg64);
+		rhash_whirlpool_process_block(ctx->hash, msg64, is_first_block);
+		is_first_block = 0;
 		index = 0;
 	}
 	/* due to optimization actually only 64-bit of message length are stored */
@@ -210,7 +291,7 @@ void rhash_whirlpool_final(whirlpool_ctx *ctx, unsigned char* result)
 		ctx->message[index++] = 0;
 	}
 	msg64[7] = be2me_64(ctx->length << 3);
-	rhash_whirlpool_process_block(ctx->hash, msg64);
+	rhash_whirlpool_process_block(ctx->hash, msg64, is_first_block);
 
 	/* save result hash */
 	be64_copy(result, 0, ctx->hash, 64);
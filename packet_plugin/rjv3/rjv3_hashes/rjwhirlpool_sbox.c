@@ -16,7 +16,7 @@
 
 #include "byte_order.h"
 
-uint64_t rhash_whirlpool_sbox[8][256] = {
+const uint64_t rhash_whirlpool_sbox[8][256] = {
 	{
 		/* C0 vectors */
 I64(0x18186018c07a30d8), I64(0x23238c2305af4a26), I64(0xcac63fc67ef991b8), I64(0xe8e8a7e8136fcdfb)
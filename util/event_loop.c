@@ -0,0 +1,204 @@
+#ifdef __linux__
+#include "minieap_common.h"
+#include "linkedlist.h"
+#include "logging.h"
+#include "event_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#define MAX_EVENTS_PER_WAKE 8
+
+typedef struct _event_watcher {
+    int fd;
+    void (*func)(int fd, void* user);
+    void* user;
+} EVENT_WATCHER;
+
+static int g_epfd = -1;
+static int g_sigfd = -1;
+static int g_stop_flag = 0;
+static void (*g_signal_func)(int signo);
+static void (*g_flush_func)(void* user);
+static void* g_flush_user;
+static int (*g_wait_func)(int epfd, void* user);
+static void* g_wait_user;
+/* content of this list is EVENT_WATCHER* */
+static LIST_ELEMENT* g_watcher_list = NULL;
+
+/* Events returned by the current epoll_wait, not yet dispatched */
+static struct epoll_event g_pending[MAX_EVENTS_PER_WAKE];
+static int g_pending_count = 0;
+
+RESULT event_loop_init() {
+    if (g_epfd >= 0) {
+        return SUCCESS;
+    }
+
+    if ((g_epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        PR_ERRNO("epoll 实例创建失败");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+void event_loop_destroy() {
+    g_flush_func = NULL;
+    g_wait_func = NULL;
+    list_destroy(&g_watcher_list, TRUE);
+    if (g_sigfd >= 0) {
+        close(g_sigfd);
+        g_sigfd = -1;
+    }
+    if (g_epfd >= 0) {
+        close(g_epfd);
+        g_epfd = -1;
+    }
+}
+
+RESULT event_loop_add_fd(int fd, void (*func)(int fd, void* user), void* user) {
+    struct epoll_event _ev;
+    EVENT_WATCHER* _watcher;
+
+    if (IS_FAIL(event_loop_init())) {
+        return FAILURE;
+    }
+
+    _watcher = (EVENT_WATCHER*)malloc(sizeof(EVENT_WATCHER));
+    if (_watcher == NULL) {
+        PR_ERRNO("无法为事件监视器分配内存");
+        return FAILURE;
+    }
+    _watcher->fd = fd;
+    _watcher->func = func;
+    _watcher->user = user;
+
+    memset(&_ev, 0, sizeof(_ev));
+    _ev.events = EPOLLIN;
+    _ev.data.ptr = _watcher;
+    if (epoll_ctl(g_epfd, EPOLL_CTL_ADD, fd, &_ev) < 0) {
+        PR_ERRNO("无法将文件描述符加入 epoll");
+        free(_watcher);
+        return FAILURE;
+    }
+
+    insert_data(&g_watcher_list, _watcher);
+    return SUCCESS;
+}
+
+/* cmpfunc: 0 = match */
+static int watcher_fd_cmpfunc(void* fd, void* watcher) {
+    return ((EVENT_WATCHER*)watcher)->fd != *(int*)fd;
+}
+
+void event_loop_remove_fd(int fd) {
+    int i;
+    EVENT_WATCHER* _watcher = lookup_data(g_watcher_list, &fd, watcher_fd_cmpfunc);
+    if (_watcher == NULL) {
+        return;
+    }
+
+    epoll_ctl(g_epfd, EPOLL_CTL_DEL, fd, NULL);
+
+    /* Do not dispatch events to the watcher we are about to free */
+    for (i = 0; i < g_pending_count; ++i) {
+        if (g_pending[i].data.ptr == _watcher) {
+            g_pending[i].data.ptr = NULL;
+        }
+    }
+    remove_data(&g_watcher_list, &fd, watcher_fd_cmpfunc, TRUE);
+}
+
+static void signalfd_handler(int fd, void* unused) {
+    struct signalfd_siginfo _info;
+
+    while (read(fd, &_info, sizeof(_info)) == sizeof(_info)) {
+        if (g_signal_func) {
+            g_signal_func(_info.ssi_signo);
+        }
+    }
+}
+
+RESULT event_loop_watch_signals(void (*func)(int signo)) {
+    sigset_t _mask;
+
+    sigemptyset(&_mask);
+    sigaddset(&_mask, SIGHUP);
+    sigaddset(&_mask, SIGINT);
+    sigaddset(&_mask, SIGTERM);
+
+    /* Signals must be blocked, or they will still be delivered the normal way */
+    if (sigprocmask(SIG_BLOCK, &_mask, NULL) < 0) {
+        PR_ERRNO("无法屏蔽终止信号");
+        return FAILURE;
+    }
+
+    if ((g_sigfd = signalfd(-1, &_mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) {
+        PR_ERRNO("signalfd 创建失败");
+        return FAILURE;
+    }
+
+    g_signal_func = func;
+    return event_loop_add_fd(g_sigfd, signalfd_handler, NULL);
+}
+
+void event_loop_set_flush_func(void (*func)(void* user), void* user) {
+    g_flush_func = func;
+    g_flush_user = user;
+}
+
+void event_loop_set_wait_func(int (*func)(int epfd, void* user), void* user) {
+    g_wait_func = func;
+    g_wait_user = user;
+}
+
+RESULT event_loop_run() {
+    int i, _ready;
+
+    g_stop_flag = 0;
+    while (!g_stop_flag) {
+        if (g_flush_func) {
+            g_flush_func(g_flush_user);
+        }
+
+        if (g_wait_func) {
+            if ((_ready = g_wait_func(g_epfd, g_wait_user)) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return FAILURE;
+            }
+            if (_ready == 0) {
+                continue; /* Handled by itself, or the loop is stopped */
+            }
+        }
+
+        g_pending_count = epoll_wait(g_epfd, g_pending, MAX_EVENTS_PER_WAKE, g_wait_func ? 0 : -1);
+        if (g_pending_count < 0) {
+            g_pending_count = 0;
+            if (errno == EINTR) {
+                continue;
+            }
+            PR_ERRNO("epoll_wait 调用失败");
+            return FAILURE;
+        }
+
+        for (i = 0; i < g_pending_count && !g_stop_flag; ++i) {
+#define WATCHER ((EVENT_WATCHER*)g_pending[i].data.ptr)
+            if (WATCHER == NULL) {
+                continue; /* Removed by previous callbacks */
+            }
+            WATCHER->func(WATCHER->fd, WATCHER->user);
+        }
+        g_pending_count = 0;
+    }
+    return SUCCESS;
+}
+
+void event_loop_stop() {
+    g_stop_flag = 1;
+}
+#endif /* __linux__ */
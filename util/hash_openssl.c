@@ -0,0 +1,52 @@
+/*
+ * Hash provider based on OpenSSL libcrypto
+ */
+#ifdef ENABLE_OPENSSL
+#include "hash_provider.h"
+#include "logging.h"
+
+#include <openssl/evp.h>
+
+static RESULT openssl_init() {
+    return EVP_md5() == NULL ? FAILURE : SUCCESS;
+}
+
+static void openssl_destroy() {
+}
+
+/*
+ * Each call has its own context, so concurrent hashes do not mix
+ */
+static RESULT openssl_md5v(const HASH_CHUNK* chunks, int count, uint8_t digest[16]) {
+    EVP_MD_CTX* _ctx;
+    unsigned int _len = 16;
+    RESULT _ret = FAILURE;
+    int i;
+
+    if ((_ctx = EVP_MD_CTX_create()) == NULL) {
+        return FAILURE;
+    }
+    if (!EVP_DigestInit_ex(_ctx, EVP_md5(), NULL)) {
+        goto out;
+    }
+    for (i = 0; i < count; ++i) {
+        if (!EVP_DigestUpdate(_ctx, chunks[i].data, chunks[i].len)) {
+            goto out;
+        }
+    }
+    if (EVP_DigestFinal_ex(_ctx, digest, &_len)) {
+        _ret = SUCCESS;
+    }
+out:
+    EVP_MD_CTX_destroy(_ctx);
+    return _ret;
+}
+
+HASH_PROVIDER g_openssl_hash_provider = {
+    .name = "openssl",
+    .description = "OpenSSL libcrypto",
+    .init = openssl_init,
+    .destroy = openssl_destroy,
+    .md5v = openssl_md5v,
+};
+#endif /* ENABLE_OPENSSL */
@@ -0,0 +1,177 @@
+#include "hash_provider.h"
+#include "logging.h"
+#include "misc.h"
+#include "md5.h"
+
+#include <string.h>
+
+/*
+ * Builtin provider, always available
+ */
+static RESULT builtin_init() {
+    return SUCCESS;
+}
+
+static void builtin_destroy() {
+}
+
+static RESULT builtin_md5v(const HASH_CHUNK* chunks, int count, uint8_t digest[16]) {
+    MD5_CTX _ctx;
+    int i;
+
+    MD5Init(&_ctx);
+    for (i = 0; i < count; ++i) {
+        MD5Update(&_ctx, (UCHAR*)chunks[i].data, chunks[i].len);
+    }
+    MD5Final(digest, &_ctx);
+    return SUCCESS;
+}
+
+static HASH_PROVIDER g_builtin_provider = {
+    .name = "builtin",
+    .description = "内置的 C 语言实现",
+    .init = builtin_init,
+    .destroy = builtin_destroy,
+    .md5v = builtin_md5v,
+};
+
+#ifdef __linux__
+extern HASH_PROVIDER g_af_alg_hash_provider;
+#endif
+#ifdef ENABLE_OPENSSL
+extern HASH_PROVIDER g_openssl_hash_provider;
+#endif
+
+static HASH_PROVIDER* g_providers[] = {
+    &g_builtin_provider,
+#ifdef __linux__
+    &g_af_alg_hash_provider,
+#endif
+#ifdef ENABLE_OPENSSL
+    &g_openssl_hash_provider,
+#endif
+};
+
+#define PROVIDER_COUNT (sizeof(g_providers) / sizeof(HASH_PROVIDER*))
+
+static HASH_PROVIDER* g_current = &g_builtin_provider;
+/* Backends initialized and self-tested, to be destroyed */
+static int g_inited[PROVIDER_COUNT];
+
+/* MD5("The quick brown fox jumps over the lazy dog") */
+static const uint8_t SELF_TEST_MD5[16] = {
+    0x9e, 0x10, 0x7d, 0x9d, 0x37, 0x2b, 0xb6, 0x82,
+    0x6b, 0xd8, 0x1d, 0x35, 0x42, 0xa4, 0x19, 0xd6
+};
+#define SELF_TEST_INPUT "The quick brown fox jumps over the lazy dog"
+/* Roughly what we hash per challenge: username + 16-byte challenge */
+#define BENCH_ROUNDS 200
+
+static RESULT self_test(HASH_PROVIDER* provider) {
+    uint8_t _digest[16];
+    HASH_CHUNK _chunks[2] = {
+        {SELF_TEST_INPUT, 10},
+        {SELF_TEST_INPUT + 10, sizeof(SELF_TEST_INPUT) - 1 - 10}
+    };
+
+    if (IS_FAIL(provider->md5v(_chunks, 2, _digest))) {
+        return FAILURE;
+    }
+    return memcmp(_digest, SELF_TEST_MD5, 16) == 0 ? SUCCESS : FAILURE;
+}
+
+static uint64_t bench_usecs(HASH_PROVIDER* provider) {
+    uint8_t _digest[16];
+    uint8_t _data[40] = {0};
+    HASH_CHUNK _chunk = {_data, sizeof(_data)};
+    uint64_t _start = get_monotonic_usecs();
+    int i;
+
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        _data[0] = i;
+        if (IS_FAIL(provider->md5v(&_chunk, 1, _digest))) {
+            return UINT64_MAX;
+        }
+    }
+    return get_monotonic_usecs() - _start;
+}
+
+static RESULT try_init(int index) {
+    if (g_inited[index]) {
+        return SUCCESS;
+    }
+    if (IS_FAIL(g_providers[index]->init())) {
+        return FAILURE;
+    }
+    if (IS_FAIL(self_test(g_providers[index]))) {
+        PR_WARN("哈希模块 %s 自检失败，将不会使用", g_providers[index]->name);
+        g_providers[index]->destroy();
+        return FAILURE;
+    }
+    /* Only usable ones, so later calls do not take a broken one */
+    g_inited[index] = TRUE;
+    return SUCCESS;
+}
+
+RESULT hash_provider_init(const char* name) {
+    int i;
+    uint64_t _usecs, _best_usecs = UINT64_MAX;
+
+    g_current = &g_builtin_provider;
+    if (name != NULL && strcmp(name, "auto") != 0) {
+        for (i = 0; i < PROVIDER_COUNT; ++i) {
+            if (strcmp(name, g_providers[i]->name) == 0) {
+                if (IS_FAIL(try_init(i))) {
+                    PR_ERR("哈希模块 %s 不可用", name);
+                    return FAILURE;
+                }
+                g_current = g_providers[i];
+                return SUCCESS;
+            }
+        }
+        PR_ERR("未知的哈希模块：%s", name);
+        return FAILURE;
+    }
+
+    for (i = 0; i < PROVIDER_COUNT; ++i) {
+        if (IS_FAIL(try_init(i))) {
+            continue;
+        }
+        _usecs = bench_usecs(g_providers[i]);
+        PR_DBG("哈希模块 %s: %d 次 MD5 用时 %llu us", g_providers[i]->name,
+               BENCH_ROUNDS, (unsigned long long)_usecs);
+        if (_usecs < _best_usecs) {
+            _best_usecs = _usecs;
+            g_current = g_providers[i];
+        }
+    }
+    PR_DBG("选择哈希模块 %s", g_current->name);
+    return SUCCESS;
+}
+
+void hash_provider_destroy() {
+    int i;
+    for (i = 0; i < PROVIDER_COUNT; ++i) {
+        if (g_inited[i]) {
+            g_providers[i]->destroy();
+            g_inited[i] = FALSE;
+        }
+    }
+    g_current = &g_builtin_provider;
+}
+
+const char* hash_provider_name() {
+    return g_current->name;
+}
+
+/*
+ * `g_current` is only set by hash_provider_init, so this is safe to be called
+ * concurrently, as long as the backend is
+ */
+uint8_t* hash_md5v(const HASH_CHUNK* chunks, int count, uint8_t digest[16]) {
+    if (IS_FAIL(g_current->md5v(chunks, count, digest))) {
+        PR_WARN("哈希模块 %s 出错，本次改用内置实现", g_current->name);
+        builtin_md5v(chunks, count, digest);
+    }
+    return digest;
+}
@@ -3,6 +3,9 @@
 LOCAL_PATH := $(call my-dir)
 
 LOCAL_SRC_FILES := $(call all-c-files-under,)
+ifneq ($(ENABLE_OPENSSL),true)
+LOCAL_SRC_FILES := $(filter-out hash_openssl.c,$(LOCAL_SRC_FILES))
+endif
 LOCAL_C_INCLUDES :=
 LOCAL_CFLAGS :=
 LOCAL_LDFLAGS :=
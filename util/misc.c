@@ -4,6 +4,9 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <time.h>
 #include <getopt.h>
 
 #include "linkedlist.h"
@@ -104,18 +107,22 @@ void gbk2utf8(char* in, size_t inlen, char* out, size_t outlen) {
 #endif
 }
 
+/*
+ * Server messages come in one frame, so they are never longer than this.
+ * 2-byte GBK characters take at most 3 bytes in UTF-8.
+ */
+#define GBK_MSG_MAX_LEN 1512
+#define GBK_MSG_UTF8_SIZE (GBK_MSG_MAX_LEN / 2 * 3 + 1)
+
 void pr_info_gbk(char* in, size_t inlen) {
-    size_t _utf8_size = inlen << 2;
-    char* _utf8_buf = (char*)malloc(_utf8_size);
-    memset(_utf8_buf, 0, _utf8_size);
-    if (_utf8_buf != NULL) {
-        gbk2utf8(in, inlen, _utf8_buf, _utf8_size);
-        PR_INFO("%s", _utf8_buf);
-        free(_utf8_buf);
-    } else {
-        _utf8_buf = in;
-        PR_INFO("%s", _utf8_buf);
+    char _utf8_buf[GBK_MSG_UTF8_SIZE] = {0};
+
+    if (inlen > GBK_MSG_MAX_LEN) {
+        inlen = GBK_MSG_MAX_LEN;
     }
+    /* Leave the last byte as terminator */
+    gbk2utf8(in, inlen, _utf8_buf, sizeof(_utf8_buf) - 1);
+    PR_INFO("%s", _utf8_buf);
 }
 
 RESULT go_background() {
@@ -182,3 +189,70 @@ void* memdup(const void* src, int n) {
     memmove(ret, src, n);
     return ret;
 }
+
+int my_system(const char* cmd) {
+    pid_t pid;
+    int status;
+    sigset_t empty_mask;
+
+    pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0) {
+        /* Do not pass our blocked signals to the script and its children */
+        sigemptyset(&empty_mask);
+        sigprocmask(SIG_SETMASK, &empty_mask, NULL);
+        execl("/bin/sh", "sh", "-c", cmd, (char*)NULL);
+        _exit(127);
+    }
+
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return -1;
+    }
+    return status;
+}
+
+uint64_t get_monotonic_usecs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t realtime_to_monotonic_usecs(uint64_t realtime_usecs) {
+    struct timespec ts;
+    uint64_t _now_real, _now_mono = get_monotonic_usecs();
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    _now_real = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    if (realtime_usecs >= _now_real) {
+        return _now_mono; /* Clock stepped back in between */
+    }
+    return _now_mono - (_now_real - realtime_usecs);
+}
+
+int secs_str2ms(const char* str) {
+    char* end;
+    double secs = strtod(str, &end);
+    if (end == str || secs < 0) {
+        return -1;
+    }
+    return (int)(secs * 1000 + 0.5);
+}
+
+char* ms2secs_str(int ms, char* buf) {
+    char* curr_pos;
+
+    my_itoa(ms / 1000, buf, 10);
+    if (ms % 1000) {
+        curr_pos = buf + strlen(buf);
+        *curr_pos++ = '.';
+        *curr_pos++ = '0' + (ms / 100) % 10;
+        *curr_pos++ = '0' + (ms / 10) % 10;
+        *curr_pos++ = '0' + ms % 10;
+        /* Strip trailing zeros */
+        while (*(curr_pos - 1) == '0') curr_pos--;
+        *curr_pos = 0;
+    }
+    return buf;
+}
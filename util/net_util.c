@@ -14,6 +14,10 @@
 #include <stdio.h>
 
 #ifdef __linux__
+#include "event_loop.h"
+#include <errno.h>
+#include <limits.h>
+#include <sys/inotify.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <linux/if_packet.h>
@@ -39,8 +43,463 @@ IP_ADDR* find_ip_with_family(LIST_ELEMENT* list, short family) {
     return (IP_ADDR*)lookup_data(list, &family, ip_addr_family_cmpfunc);
 }
 
+#ifdef __linux__
+/*
+ * Interface cache
+ *
+ * MAC, addresses and IPv4 default gateway of the interface we work on are loaded
+ * once with netlink requests, then kept current by RTNLGRP_LINK / RTNLGRP_IPV4_IFADDR /
+ * RTNLGRP_IPV6_IFADDR / RTNLGRP_IPV4_ROUTE notifications. getifaddrs() would dump
+ * every interface on the system each time, and the gateway would need the whole
+ * routing table.
+ *
+ * With strict checking (Linux 4.20+), the kernel only dumps addresses and main table
+ * routes of our interface. Older kernels ignore the filters and we filter here.
+ *
+ * Notifications are read in the event loop, and also right before each lookup,
+ * so changes made by DHCP scripts are seen as soon as the script returns.
+ */
+#define IFACE_CACHE_MAX_ADDRS 32
+#define NL_BUFSIZE 8192
+
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK 12
+#endif
+
+static struct {
+    int fd; /* -1 = cache not in use */
+    int ifindex; /* 0 = interface does not exist */
+    char ifname[IFNAMSIZ];
+    int stale; /* Notifications were lost, reload before next lookup */
+    int has_mac;
+    uint8_t mac[6];
+    int addr_count;
+    IP_ADDR addrs[IFACE_CACHE_MAX_ADDRS];
+    int has_gateway;
+    int gateway_stale; /* Routes may be flushed without notifications */
+    uint8_t gateway[4];
+    uint32_t gateway_metric; /* The kernel uses the lowest one */
+    uint32_t generation; /* Bumped on every change, never 0 */
+} g_iface_cache = {.fd = -1, .generation = 1};
+
+static void iface_cache_changed() {
+    if (++g_iface_cache.generation == 0) {
+        g_iface_cache.generation = 1;
+    }
+}
+
+static void iface_cache_clear() {
+    iface_cache_changed();
+    g_iface_cache.has_mac = FALSE;
+    g_iface_cache.addr_count = 0;
+    g_iface_cache.has_gateway = FALSE;
+    g_iface_cache.gateway_stale = FALSE;
+}
+
+static void prefix_to_mask(uint8_t* mask, int prefixlen) {
+    int i;
+    for (i = 0; prefixlen > 0; ++i, prefixlen -= 8) {
+        mask[i] = prefixlen >= 8 ? 0xff : (0xff << (8 - prefixlen)) & 0xff;
+    }
+}
+
+static void iface_cache_handle_link(struct nlmsghdr* nl_hdr) {
+    struct ifinfomsg* _ifi = (struct ifinfomsg*)NLMSG_DATA(nl_hdr);
+    struct rtattr* _rta = IFLA_RTA(_ifi);
+    int _rta_len = IFLA_PAYLOAD(nl_hdr);
+    struct rtattr* _name = NULL, *_addr = NULL;
+
+    for (; RTA_OK(_rta, _rta_len); _rta = RTA_NEXT(_rta, _rta_len)) {
+        if (_rta->rta_type == IFLA_IFNAME) {
+            _name = _rta;
+        } else if (_rta->rta_type == IFLA_ADDRESS) {
+            _addr = _rta;
+        }
+    }
+
+    if (_ifi->ifi_index != g_iface_cache.ifindex) {
+        /* Ours may show up later */
+        if (nl_hdr->nlmsg_type != RTM_NEWLINK || _name == NULL
+                || strncmp(RTA_DATA(_name), g_iface_cache.ifname, IFNAMSIZ) != 0) {
+            return;
+        }
+        PR_DBG("接口 %s 已出现", g_iface_cache.ifname);
+        iface_cache_clear();
+        g_iface_cache.ifindex = _ifi->ifi_index;
+    } else if (nl_hdr->nlmsg_type == RTM_DELLINK
+            || (_name != NULL && strncmp(RTA_DATA(_name), g_iface_cache.ifname, IFNAMSIZ) != 0)) {
+        /* Gone or renamed */
+        PR_DBG("接口 %s 已消失", g_iface_cache.ifname);
+        iface_cache_clear();
+        g_iface_cache.ifindex = 0;
+        return;
+    }
+
+    if (_addr != NULL && RTA_PAYLOAD(_addr) >= sizeof(g_iface_cache.mac)
+            && (!g_iface_cache.has_mac || memcmp(g_iface_cache.mac, RTA_DATA(_addr), sizeof(g_iface_cache.mac)) != 0)) {
+        memmove(g_iface_cache.mac, RTA_DATA(_addr), sizeof(g_iface_cache.mac));
+        g_iface_cache.has_mac = TRUE;
+        iface_cache_changed();
+    }
+
+    if (!(_ifi->ifi_flags & IFF_UP)) {
+        g_iface_cache.gateway_stale = TRUE;
+    }
+}
+
+static void iface_cache_handle_addr(struct nlmsghdr* nl_hdr) {
+    struct ifaddrmsg* _ifa = (struct ifaddrmsg*)NLMSG_DATA(nl_hdr);
+    struct rtattr* _rta = IFA_RTA(_ifa);
+    int _rta_len = IFA_PAYLOAD(nl_hdr);
+    struct rtattr* _local = NULL, *_addr = NULL;
+    IP_ADDR _ip = {0};
+    int _ip_len, i;
+
+    if (g_iface_cache.ifindex == 0 || _ifa->ifa_index != g_iface_cache.ifindex) {
+        return;
+    }
+
+    if (_ifa->ifa_family == AF_INET) {
+        _ip_len = 4;
+        if (nl_hdr->nlmsg_type == RTM_DELADDR) {
+            g_iface_cache.gateway_stale = TRUE;
+        }
+    } else if (_ifa->ifa_family == AF_INET6) {
+        _ip_len = 16;
+    } else {
+        return;
+    }
+
+    for (; RTA_OK(_rta, _rta_len); _rta = RTA_NEXT(_rta, _rta_len)) {
+        if (_rta->rta_type == IFA_LOCAL) {
+            _local = _rta;
+        } else if (_rta->rta_type == IFA_ADDRESS) {
+            _addr = _rta;
+        }
+    }
+
+    /* Same as getifaddrs(): IFA_ADDRESS is the peer on point-to-point links */
+    if (_local != NULL) {
+        _addr = _local;
+    }
+    if (_addr == NULL || RTA_PAYLOAD(_addr) < _ip_len) {
+        return;
+    }
+
+    _ip.family = _ifa->ifa_family;
+    memmove(_ip.ip, RTA_DATA(_addr), _ip_len);
+    prefix_to_mask(_ip.mask, _ifa->ifa_prefixlen > _ip_len * 8 ? _ip_len * 8 : _ifa->ifa_prefixlen);
+
+    for (i = 0; i < g_iface_cache.addr_count; ++i) {
+        if (g_iface_cache.addrs[i].family == _ip.family
+                && memcmp(g_iface_cache.addrs[i].ip, _ip.ip, _ip_len) == 0) {
+            break;
+        }
+    }
+
+    if (nl_hdr->nlmsg_type == RTM_NEWADDR) {
+        if (i == IFACE_CACHE_MAX_ADDRS) {
+            PR_WARN("接口 %s 上的地址过多，部分地址将被忽略", g_iface_cache.ifname);
+            return;
+        }
+        g_iface_cache.addrs[i] = _ip;
+        if (i == g_iface_cache.addr_count) {
+            g_iface_cache.addr_count++;
+        }
+        iface_cache_changed();
+    } else if (i < g_iface_cache.addr_count) {
+        /* RTM_DELADDR. Keep the order, as getifaddrs() does */
+        memmove(&g_iface_cache.addrs[i], &g_iface_cache.addrs[i + 1],
+                (g_iface_cache.addr_count - i - 1) * sizeof(IP_ADDR));
+        g_iface_cache.addr_count--;
+        iface_cache_changed();
+    }
+}
+
+/* Default routes in main table through our interface */
+static void iface_cache_handle_route(struct nlmsghdr* nl_hdr) {
+    struct rtmsg* _rtm = (struct rtmsg*)NLMSG_DATA(nl_hdr);
+    struct rtattr* _rta = RTM_RTA(_rtm);
+    int _rta_len = RTM_PAYLOAD(nl_hdr);
+    uint32_t _table = _rtm->rtm_table;
+    uint32_t _oif = 0;
+    uint32_t _metric = 0;
+    uint8_t _gateway[4] = {0};
+
+    if (g_iface_cache.ifindex == 0 || _rtm->rtm_family != AF_INET || _rtm->rtm_dst_len != 0) {
+        return;
+    }
+
+    for (; RTA_OK(_rta, _rta_len); _rta = RTA_NEXT(_rta, _rta_len)) {
+        switch (_rta->rta_type) {
+            case RTA_TABLE:
+                _table = *(uint32_t*)RTA_DATA(_rta);
+                break;
+            case RTA_OIF:
+                _oif = *(uint32_t*)RTA_DATA(_rta);
+                break;
+            case RTA_GATEWAY:
+                memmove(_gateway, RTA_DATA(_rta), sizeof(_gateway));
+                break;
+            case RTA_PRIORITY:
+                _metric = *(uint32_t*)RTA_DATA(_rta);
+                break;
+        }
+    }
+
+    if (_table != RT_TABLE_MAIN || _oif != g_iface_cache.ifindex) {
+        return;
+    }
+
+    if (nl_hdr->nlmsg_type == RTM_NEWROUTE) {
+        if (g_iface_cache.has_gateway && _metric > g_iface_cache.gateway_metric) {
+            return; /* Not the one in use */
+        }
+        /* No RTA_GATEWAY (e.g. PPP) is 0.0.0.0, as it always was */
+        memmove(g_iface_cache.gateway, _gateway, sizeof(_gateway));
+        g_iface_cache.gateway_metric = _metric;
+        g_iface_cache.has_gateway = TRUE;
+        iface_cache_changed();
+    } else if (g_iface_cache.has_gateway && _metric == g_iface_cache.gateway_metric
+            && memcmp(g_iface_cache.gateway, _gateway, sizeof(_gateway)) == 0) {
+        /* Another default route may take over, dump them again */
+        g_iface_cache.has_gateway = FALSE;
+        g_iface_cache.gateway_stale = TRUE;
+        iface_cache_changed();
+    }
+}
+
+/*
+ * Handle everything received. Dump replies and notifications look the same.
+ *
+ * Return: 1 if end of a dump or an ACK is seen, -1 on netlink errors, 0 otherwise
+ */
+static int iface_cache_handle_msgs(uint8_t* buf, int len) {
+    struct nlmsghdr* _nl_hdr = (struct nlmsghdr*)buf;
+    int _ret = 0;
+
+    for (; NLMSG_OK(_nl_hdr, len); _nl_hdr = NLMSG_NEXT(_nl_hdr, len)) {
+        switch (_nl_hdr->nlmsg_type) {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+                iface_cache_handle_link(_nl_hdr);
+                break;
+            case RTM_NEWADDR:
+            case RTM_DELADDR:
+                iface_cache_handle_addr(_nl_hdr);
+                break;
+            case RTM_NEWROUTE:
+            case RTM_DELROUTE:
+                iface_cache_handle_route(_nl_hdr);
+                break;
+            case NLMSG_DONE:
+                _ret = 1;
+                break;
+            case NLMSG_ERROR:
+                if (((struct nlmsgerr*)NLMSG_DATA(_nl_hdr))->error == 0) {
+                    _ret = 1; /* ACK */
+                    break;
+                }
+                PR_WARN("NETLINK 报告了一个错误 (%d)", ((struct nlmsgerr*)NLMSG_DATA(_nl_hdr))->error);
+                return -1;
+        }
+    }
+    return _ret;
+}
+
+/*
+ * Read until the end of current dump if `until_done`, or until nothing is pending
+ */
+static RESULT iface_cache_recv(int until_done) {
+    uint8_t _buf[NL_BUFSIZE];
+    int _len, _ret;
+
+    for (;;) {
+        _len = recv(g_iface_cache.fd, _buf, sizeof(_buf), until_done ? 0 : MSG_DONTWAIT);
+        if (_len < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == ENOBUFS) {
+                /* Some notifications are lost. Start over */
+                g_iface_cache.stale = TRUE;
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return SUCCESS;
+            }
+            PR_ERRNO("无法从 NETLINK 接收数据");
+            return FAILURE;
+        }
+
+        _ret = iface_cache_handle_msgs(_buf, _len);
+        if (_ret < 0) {
+            return FAILURE;
+        } else if (_ret > 0 && until_done) {
+            return SUCCESS;
+        }
+    }
+}
+
+/*
+ * Send a request with `msg` as its body, followed by RTA_OIF if `oif` != 0,
+ * and handle the replies until the end
+ */
+static RESULT iface_cache_request(int type, int flags, const void* msg, int msg_len, uint32_t oif) {
+    uint8_t _buf[NLMSG_SPACE(sizeof(struct ifinfomsg)) + RTA_SPACE(sizeof(uint32_t))] = {0};
+    struct nlmsghdr* _nl_hdr = (struct nlmsghdr*)_buf;
+    struct rtattr* _rta;
+
+    _nl_hdr->nlmsg_len = NLMSG_LENGTH(msg_len);
+    _nl_hdr->nlmsg_type = type;
+    _nl_hdr->nlmsg_flags = NLM_F_REQUEST | flags;
+    memmove(NLMSG_DATA(_nl_hdr), msg, msg_len);
+
+    if (oif != 0) {
+        _rta = (struct rtattr*)(_buf + NLMSG_ALIGN(_nl_hdr->nlmsg_len));
+        _rta->rta_type = RTA_OIF;
+        _rta->rta_len = RTA_LENGTH(sizeof(oif));
+        memmove(RTA_DATA(_rta), &oif, sizeof(oif));
+        _nl_hdr->nlmsg_len = NLMSG_ALIGN(_nl_hdr->nlmsg_len) + _rta->rta_len;
+    }
+
+    if (send(g_iface_cache.fd, _buf, _nl_hdr->nlmsg_len, 0) < 0) {
+        PR_ERRNO("无法向 NETLINK 发送请求");
+        return FAILURE;
+    }
+    return iface_cache_recv(TRUE);
+}
+
+static RESULT iface_cache_load_gateway() {
+    struct rtmsg _rtm = {.rtm_family = AF_INET, .rtm_table = RT_TABLE_MAIN};
+
+    g_iface_cache.has_gateway = FALSE;
+    g_iface_cache.gateway_stale = FALSE;
+    iface_cache_changed();
+    if (g_iface_cache.ifindex == 0) {
+        return SUCCESS;
+    }
+    if (IS_FAIL(iface_cache_request(RTM_GETROUTE, NLM_F_DUMP, &_rtm, sizeof(_rtm), g_iface_cache.ifindex))) {
+        g_iface_cache.gateway_stale = TRUE;
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static RESULT iface_cache_load() {
+    iface_cache_clear();
+    g_iface_cache.stale = FALSE;
+    g_iface_cache.ifindex = if_nametoindex(g_iface_cache.ifname);
+
+    if (g_iface_cache.ifindex == 0) {
+        /* Not yet. Will know from RTM_NEWLINK */
+        return SUCCESS;
+    }
+
+    struct ifinfomsg _ifi = {.ifi_family = AF_UNSPEC, .ifi_index = g_iface_cache.ifindex};
+    struct ifaddrmsg _ifa = {.ifa_family = AF_UNSPEC, .ifa_index = g_iface_cache.ifindex};
+
+    /* Notifications in between are handled in the same way, no harm */
+    if (IS_FAIL(iface_cache_request(RTM_GETLINK, NLM_F_ACK, &_ifi, sizeof(_ifi), 0))
+            || IS_FAIL(iface_cache_request(RTM_GETADDR, NLM_F_DUMP, &_ifa, sizeof(_ifa), 0))
+            || IS_FAIL(iface_cache_load_gateway())) {
+        g_iface_cache.stale = TRUE;
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static void iface_cache_event_handler(int fd, void* unused) {
+    iface_cache_recv(FALSE);
+}
+
+/*
+ * Return: TRUE if `ifname` can be looked up in the cache, which is now up to date
+ */
+static int iface_cache_ready(const char* ifname) {
+    if (g_iface_cache.fd < 0 || strncmp(ifname, g_iface_cache.ifname, IFNAMSIZ) != 0) {
+        return FALSE;
+    }
+    if (IS_FAIL(iface_cache_recv(FALSE))) {
+        return FALSE;
+    }
+    if (g_iface_cache.stale && IS_FAIL(iface_cache_load())) {
+        return FALSE;
+    }
+    if (g_iface_cache.gateway_stale && IS_FAIL(iface_cache_load_gateway())) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+RESULT iface_cache_init(const char* ifname) {
+    struct sockaddr_nl _addr = {0};
+    int _on = 1;
+
+    iface_cache_destroy();
+
+    if ((g_iface_cache.fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+        PR_ERRNO("NETLINK 套接字打开失败");
+        return FAILURE;
+    }
+
+    _addr.nl_family = AF_NETLINK;
+    _addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE;
+    if (bind(g_iface_cache.fd, (struct sockaddr*)&_addr, sizeof(_addr)) < 0) {
+        PR_ERRNO("NETLINK 套接字绑定失败");
+        goto err;
+    }
+
+    /* Let the kernel filter dumps for us. Fine if unsupported */
+    setsockopt(g_iface_cache.fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &_on, sizeof(_on));
+
+    strncpy(g_iface_cache.ifname, ifname, IFNAMSIZ - 1);
+    if (IS_FAIL(iface_cache_load())) {
+        goto err;
+    }
+
+    if (IS_FAIL(event_loop_add_fd(g_iface_cache.fd, iface_cache_event_handler, NULL))) {
+        goto err;
+    }
+    return SUCCESS;
+err:
+    close(g_iface_cache.fd);
+    g_iface_cache.fd = -1;
+    return FAILURE;
+}
+
+void iface_cache_destroy() {
+    if (g_iface_cache.fd >= 0) {
+        event_loop_remove_fd(g_iface_cache.fd);
+        close(g_iface_cache.fd);
+        g_iface_cache.fd = -1;
+    }
+}
+
+uint32_t iface_cache_generation(const char* ifname) {
+    if (!iface_cache_ready(ifname)) {
+        return 0;
+    }
+    return g_iface_cache.generation;
+}
+#else
+uint32_t iface_cache_generation(const char* ifname) {
+    return 0;
+}
+#endif
+
 RESULT obtain_iface_mac(const char* ifname, uint8_t* adr_buf) {
     struct ifaddrs *ifaddrs, *if_curr;
+    int _found = FALSE;
+
+#ifdef __linux__
+    if (iface_cache_ready(ifname)) {
+        if (!g_iface_cache.has_mac) {
+            return FAILURE;
+        }
+        memmove(adr_buf, g_iface_cache.mac, sizeof(g_iface_cache.mac));
+        return SUCCESS;
+    }
+#endif
+
     if (getifaddrs(&ifaddrs) < 0) {
         PR_ERRNO("通过 getifaddrs 获取 MAC 地址失败");
         return FAILURE;
@@ -48,25 +507,39 @@ RESULT obtain_iface_mac(const char* ifname, uint8_t* adr_buf) {
 
     if_curr = ifaddrs;
     do {
-        if (strcmp(if_curr->ifa_name, ifname) == 0) {
+        if (strcmp(if_curr->ifa_name, ifname) == 0 && if_curr->ifa_addr != NULL) {
 #ifdef __linux__
             if (if_curr->ifa_addr->sa_family == AF_PACKET) {
                 memmove(adr_buf, ((struct sockaddr_ll*)if_curr->ifa_addr)->sll_addr, 6);
+                _found = TRUE;
             }
 #else
             if (if_curr->ifa_addr->sa_family == AF_LINK) {
                 memmove(adr_buf, LLADDR((struct sockaddr_dl*)if_curr->ifa_addr), 6);
+                _found = TRUE;
             }
 #endif
         }
     } while ((if_curr = if_curr->ifa_next));
     freeifaddrs(ifaddrs);
-    return SUCCESS;
+
+    return _found ? SUCCESS : FAILURE;
 }
 
 RESULT obtain_iface_ip_mask(const char* ifname, LIST_ELEMENT** list) {
     struct ifaddrs *ifaddrs, *if_curr;
     IP_ADDR *addr;
+
+#ifdef __linux__
+    if (iface_cache_ready(ifname)) {
+        int i;
+        for (i = 0; i < g_iface_cache.addr_count; ++i) {
+            insert_data(list, memdup(&g_iface_cache.addrs[i], sizeof(IP_ADDR)));
+        }
+        return SUCCESS;
+    }
+#endif
+
     if (getifaddrs(&ifaddrs) < 0) {
         PR_ERRNO("通过 getifaddrs 获取 IP 地址失败");
         return FAILURE;
@@ -100,13 +573,13 @@ void free_ip_list(LIST_ELEMENT** list) {
     list_destroy(list, TRUE);
 }
 
-RESULT obtain_dns_list(LIST_ELEMENT** list) {
-    FILE* _fp = fopen("/etc/resolv.conf", "r");
+static RESULT read_dns_list(const char* path, LIST_ELEMENT** list) {
+    FILE* _fp = fopen(path, "r");
     char _line_buf[MAX_LINE_LEN] = {0};
     char* _line_buf_1;
 
     if (_fp == NULL) {
-        PR_ERRNO("无法从 /etc/resolv.conf 获取 DNS 信息");
+        PR_ERR("无法从 %s 获取 DNS 信息: %s (%d)", path, strerror(errno), errno);
         return FAILURE;
     }
 
@@ -129,13 +602,235 @@ RESULT obtain_dns_list(LIST_ELEMENT** list) {
     return SUCCESS;
 }
 
+#ifdef __linux__
+/*
+ * Nameservers in resolv.conf are parsed again only after inotify reports a change.
+ *
+ * resolv.conf is usually replaced by rename(), and often is a symlink (into /tmp on
+ * OpenWrt, /run elsewhere). So the directory of every link on the way is watched
+ * for that name, rather than the file itself.
+ */
+#define DNS_CACHE_MAX_LINKS 4
+#define DNS_CACHE_WATCH_MASK (IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO \
+                                | IN_DELETE_SELF | IN_MOVE_SELF)
+
+static struct {
+    int fd; /* inotify */
+    char path[PATH_MAX];
+    int stale;
+    uint32_t generation; /* Bumped on every reload, never 0 */
+    int watch_count;
+    struct {
+        int wd;
+        char name[NAME_MAX + 1];
+    } watches[DNS_CACHE_MAX_LINKS];
+    LIST_ELEMENT* list;
+} g_dns_cache = {.fd = -1, .generation = 1};
+
+static int dns_cache_watching(int wd) {
+    int i;
+
+    for (i = 0; i < g_dns_cache.watch_count; ++i) {
+        if (g_dns_cache.watches[i].wd == wd) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Watch the directories of resolv.conf and whatever it links to.
+ *
+ * Watching a directory again gives the same wd, so only those no longer
+ * on the way are removed. Removing a watch queues an IN_IGNORED for it.
+ */
+static void dns_cache_watch() {
+    char _path[PATH_MAX], _target[PATH_MAX];
+    char* _slash;
+    ssize_t _len;
+    int _old_wds[DNS_CACHE_MAX_LINKS];
+    int _old_count = g_dns_cache.watch_count;
+    int i;
+
+    for (i = 0; i < _old_count; ++i) {
+        _old_wds[i] = g_dns_cache.watches[i].wd;
+    }
+    g_dns_cache.watch_count = 0;
+
+    strncpy(_path, g_dns_cache.path, sizeof(_path) - 1);
+    _path[sizeof(_path) - 1] = 0;
+    while (g_dns_cache.watch_count < DNS_CACHE_MAX_LINKS) {
+        _slash = strrchr(_path, '/');
+        if (_slash == NULL) {
+            break;
+        }
+
+        *_slash = 0;
+        int _wd = inotify_add_watch(g_dns_cache.fd, _slash == _path ? "/" : _path, DNS_CACHE_WATCH_MASK);
+        *_slash = '/';
+        if (_wd < 0) {
+            break;
+        }
+        g_dns_cache.watches[g_dns_cache.watch_count].wd = _wd;
+        strncpy(g_dns_cache.watches[g_dns_cache.watch_count].name, _slash + 1, NAME_MAX);
+        g_dns_cache.watch_count++;
+
+        if ((_len = readlink(_path, _target, sizeof(_target) - 1)) < 0) {
+            break; /* Not a link, or gone */
+        }
+        _target[_len] = 0;
+
+        if (_target[0] == '/') {
+            strcpy(_path, _target);
+        } else {
+            /* Relative to the directory of the link */
+            _slash[1] = 0;
+            if (strlen(_path) + _len >= sizeof(_path)) {
+                break;
+            }
+            strcat(_path, _target);
+        }
+    }
+
+    for (i = 0; i < _old_count; ++i) {
+        if (!dns_cache_watching(_old_wds[i])) {
+            /* Same wd may appear twice, EINVAL the second time. No harm */
+            inotify_rm_watch(g_dns_cache.fd, _old_wds[i]);
+        }
+    }
+}
+
+static void dns_cache_recv() {
+    uint8_t _buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct inotify_event* _event;
+    ssize_t _len;
+    int i;
+
+    while ((_len = read(g_dns_cache.fd, _buf, sizeof(_buf))) > 0) {
+        for (_event = (struct inotify_event*)_buf; (uint8_t*)_event < _buf + _len;
+                _event = (struct inotify_event*)((uint8_t*)_event + sizeof(*_event) + _event->len)) {
+            if (_event->mask & IN_IGNORED) {
+                /* Ours are removed by the kernel (directory gone), others by us */
+                if (dns_cache_watching(_event->wd)) {
+                    g_dns_cache.stale = TRUE;
+                }
+                continue;
+            }
+            if (_event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                g_dns_cache.stale = TRUE;
+                continue;
+            }
+            for (i = 0; i < g_dns_cache.watch_count; ++i) {
+                if (_event->len > 0 && _event->wd == g_dns_cache.watches[i].wd
+                        && strcmp(_event->name, g_dns_cache.watches[i].name) == 0) {
+                    g_dns_cache.stale = TRUE;
+                }
+            }
+        }
+    }
+}
+
+static RESULT dns_cache_load() {
+    /* Changes during the read will make it stale again */
+    g_dns_cache.stale = FALSE;
+    if (++g_dns_cache.generation == 0) {
+        g_dns_cache.generation = 1;
+    }
+    dns_cache_watch();
+
+    free_dns_list(&g_dns_cache.list);
+    if (IS_FAIL(read_dns_list(g_dns_cache.path, &g_dns_cache.list))) {
+        free_dns_list(&g_dns_cache.list);
+        g_dns_cache.stale = TRUE;
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+static void dns_cache_event_handler(int fd, void* unused) {
+    dns_cache_recv();
+}
+
+/*
+ * Return: if the cache is now up to date. Errors are the same as reading resolv.conf
+ */
+static RESULT dns_cache_update() {
+    dns_cache_recv();
+    if (g_dns_cache.stale) {
+        return dns_cache_load();
+    }
+    return SUCCESS;
+}
+
+RESULT dns_cache_init(const char* path) {
+    dns_cache_destroy();
+
+    if ((g_dns_cache.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+        PR_ERRNO("inotify 初始化失败");
+        return FAILURE;
+    }
+    strncpy(g_dns_cache.path, path, sizeof(g_dns_cache.path) - 1);
+
+    /* No resolv.conf yet is fine, we will know when it is there */
+    dns_cache_load();
+    if (g_dns_cache.watch_count == 0) {
+        PR_ERR("无法监视 %s 的变化: %s (%d)", path, strerror(errno), errno);
+        goto err;
+    }
+
+    if (IS_FAIL(event_loop_add_fd(g_dns_cache.fd, dns_cache_event_handler, NULL))) {
+        goto err;
+    }
+    return SUCCESS;
+err:
+    dns_cache_destroy();
+    return FAILURE;
+}
+
+void dns_cache_destroy() {
+    if (g_dns_cache.fd >= 0) {
+        event_loop_remove_fd(g_dns_cache.fd);
+        close(g_dns_cache.fd);
+        g_dns_cache.fd = -1;
+    }
+    g_dns_cache.watch_count = 0;
+    free_dns_list(&g_dns_cache.list);
+}
+
+uint32_t dns_cache_generation() {
+    if (g_dns_cache.fd < 0 || IS_FAIL(dns_cache_update())) {
+        return 0;
+    }
+    return g_dns_cache.generation;
+}
+#else
+uint32_t dns_cache_generation() {
+    return 0;
+}
+#endif
+
+RESULT obtain_dns_list(LIST_ELEMENT** list) {
+#ifdef __linux__
+    if (g_dns_cache.fd >= 0) {
+        LIST_ELEMENT* _dns;
+        if (IS_FAIL(dns_cache_update())) {
+            return FAILURE;
+        }
+        for (_dns = g_dns_cache.list; _dns != NULL; _dns = _dns->next) {
+            insert_data(list, strdup(_dns->content));
+        }
+        return SUCCESS;
+    }
+#endif
+    return read_dns_list(RESOLV_CONF_PATH, list);
+}
+
 void free_dns_list(LIST_ELEMENT** list) {
     list_destroy(list, TRUE);
 }
 
 #ifdef __linux__
 /* http://stackoverflow.com/a/3288983/5701966 */
-#define NL_BUFSIZE 8192
 static int read_from_netlink_socket(int sockfd, uint8_t *buf, int seq, int pid) {
     struct nlmsghdr *nlHdr;
     int readLen = 0, msgLen = 0;
@@ -224,6 +919,14 @@ RESULT obtain_iface_ipv4_gateway(const char* ifname, uint8_t* buf) {
 
     int sockfd, len, msg_seq = 0, rand_pid = rand() % 65536;
 
+    if (iface_cache_ready(ifname)) {
+        if (!g_iface_cache.has_gateway) {
+            return FAILURE;
+        }
+        memmove(buf, g_iface_cache.gateway, sizeof(g_iface_cache.gateway));
+        return SUCCESS;
+    }
+
     if ((sockfd = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE)) < 0) {
         PR_ERRNO("NETLINK 套接字打开失败");
         return FAILURE;
@@ -14,10 +14,21 @@ RESULT append_to_frame(ETH_EAP_FRAME* frame, const uint8_t* data, int len) {
     return SUCCESS;
 }
 
+RESULT frame_copy(ETH_EAP_FRAME* dst, const ETH_EAP_FRAME* src) {
+    if (src->actual_len > dst->buffer_len)
+        return FAILURE;
+
+    memmove(dst->content, src->content, src->actual_len);
+    dst->actual_len = src->actual_len;
+    dst->recv_usecs = src->recv_usecs;
+    return SUCCESS;
+}
+
 ETH_EAP_FRAME* frame_duplicate(const ETH_EAP_FRAME* frame) {
     ETH_EAP_FRAME* _frame = (ETH_EAP_FRAME*)malloc(sizeof(ETH_EAP_FRAME));
     _frame->actual_len = frame->actual_len;
     _frame->buffer_len = frame->buffer_len;
+    _frame->recv_usecs = frame->recv_usecs;
     _frame->content = (uint8_t*)malloc(_frame->actual_len);
     if (_frame->content == NULL) {
         return NULL;
@@ -0,0 +1,62 @@
+#include "rtt_estimator.h"
+
+#include <string.h>
+
+/* Clock granularity, see RFC 6298 */
+#define RTT_CLOCK_GRANULARITY_US 1000
+
+void rtt_estimator_init(RTT_ESTIMATOR* est, int initial_rto_ms, int min_rto_ms, int max_rto_ms) {
+    memset(est, 0, sizeof(RTT_ESTIMATOR));
+    est->initial_rto_ms = initial_rto_ms;
+    est->min_rto_ms = min_rto_ms;
+    est->max_rto_ms = max_rto_ms;
+}
+
+void rtt_estimator_sample(RTT_ESTIMATOR* est, uint64_t rtt_us) {
+    uint64_t _delta;
+
+    if (est->samples++ == 0) {
+        est->srtt_us = rtt_us;
+        est->rttvar_us = rtt_us / 2;
+    } else {
+        /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R */
+        _delta = est->srtt_us > rtt_us ? est->srtt_us - rtt_us : rtt_us - est->srtt_us;
+        est->rttvar_us = (3 * est->rttvar_us + _delta) / 4;
+        est->srtt_us = (7 * est->srtt_us + rtt_us) / 8;
+    }
+    est->backoff = 0;
+}
+
+void rtt_estimator_backoff(RTT_ESTIMATOR* est) {
+    /* Stop counting once we hit the ceiling, or the shift overflows */
+    if (rtt_estimator_rto_ms(est) < est->max_rto_ms) {
+        est->backoff++;
+    }
+}
+
+void rtt_estimator_reset_backoff(RTT_ESTIMATOR* est) {
+    est->backoff = 0;
+}
+
+int rtt_estimator_rto_ms(const RTT_ESTIMATOR* est) {
+    uint64_t _rto_ms;
+    uint64_t _var_us = 4 * est->rttvar_us;
+
+    if (est->samples == 0) {
+        _rto_ms = est->initial_rto_ms;
+    } else {
+        if (_var_us < RTT_CLOCK_GRANULARITY_US) {
+            _var_us = RTT_CLOCK_GRANULARITY_US;
+        }
+        _rto_ms = (est->srtt_us + _var_us + 999) / 1000;
+    }
+
+    if (_rto_ms < est->min_rto_ms) {
+        _rto_ms = est->min_rto_ms;
+    }
+    _rto_ms <<= est->backoff;
+    if (_rto_ms > est->max_rto_ms) {
+        _rto_ms = est->max_rto_ms;
+    }
+    return (int)_rto_ms;
+}
@@ -1,189 +1,363 @@
 #include "minieap_common.h"
-#include "linkedlist.h"
 #include "logging.h"
 #include "misc.h"
 #include "sched_alarm.h"
 
-#include <limits.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <sys/time.h>
+
+#ifdef __linux__
+#include "event_loop.h"
+#include <sys/timerfd.h>
+#endif
+
+/*
+ * Events live in a fixed pool, so scheduling does not malloc.
+ * Low bits of the ID is the pool slot, high bits is a generation counter
+ * to tell stale IDs (of fired or unscheduled events) from the current one.
+ */
+#define ALARM_SLOT_BITS 6
+#define ALARM_POOL_SIZE (1 << ALARM_SLOT_BITS)
+#define ALARM_SLOT_MASK (ALARM_POOL_SIZE - 1)
+#define ALARM_MAX_GENERATION (INT32_MAX >> ALARM_SLOT_BITS)
 
 typedef struct _alarm_event {
-    int remaining;
-    int id;
-    int marked_delete;
+    uint64_t deadline; /* Absolute CLOCK_MONOTONIC time in ms */
+    uint32_t period; /* ms, 0 = one-shot */
+    int id; /* 0 = slot not in use */
+    int heap_index;
+    int generation;
     void (*func)(void*);
     void* user;
 } ALARM_EVENT;
 
-static LIST_ELEMENT* g_alarm_list = NULL;
-static LIST_ELEMENT* g_alarm_list_add_temp = NULL;
-static int g_last_id = 0;
+static ALARM_EVENT g_alarm_pool[ALARM_POOL_SIZE];
+/* Stack of unused slots in the pool */
+static int g_free_slots[ALARM_POOL_SIZE];
+static int g_free_count = -1; /* -1 = not initialized */
+/* Binary min-heap ordered by deadline */
+static ALARM_EVENT* g_alarm_heap[ALARM_POOL_SIZE];
+static int g_heap_size = 0;
 static int g_ringing = 0;
-static int g_last_set_time = 0;
+#ifdef __linux__
+static int g_timerfd = -1;
+static void (*g_timer_func)(uint64_t deadline_ms, void* user);
+static void* g_timer_user;
+#endif
+
+static uint64_t now_ms() {
+    return get_monotonic_usecs() / 1000;
+}
+
+/*
+ * The signal handler works on the heap on platforms without timerfd.
+ * Keep it away when we are modifying the heap.
+ */
+#ifdef __linux__
+#define ALARM_LOCK()
+#define ALARM_UNLOCK()
+#else
+static sigset_t g_alarm_saved_mask;
+#define ALARM_LOCK() \
+    do { \
+        sigset_t _mask; \
+        sigemptyset(&_mask); \
+        sigaddset(&_mask, SIGALRM); \
+        sigprocmask(SIG_BLOCK, &_mask, &g_alarm_saved_mask); \
+    } while (0)
+#define ALARM_UNLOCK() sigprocmask(SIG_SETMASK, &g_alarm_saved_mask, NULL)
+#endif
 
 #ifdef DEBUG
-static void print_list(LIST_ELEMENT** list) {
-    ALARM_EVENT* elem;
-    LIST_ELEMENT** ref = list;
-    while (*ref) {
-        PR_DBG("List print: node at %p", *ref);
-        PR_DBG("    next at %p", (*ref)->next);
-        PR_DBG("    content at %p", (*ref)->content);
-        elem = (*ref)->content;
-        PR_DBG("    remain %d", elem->remaining);
-        PR_DBG("    id %d", elem->id);
-        PR_DBG("    marked delete %d", elem->marked_delete);
-        PR_DBG("    func %p", elem->func);
-        PR_DBG("    user %p", elem->user);
-        ref = &(*ref)->next;
-    }
-    PR_DBG("List print end.");
+static void print_heap() {
+    int i;
+    PR_DBG("Heap print: %d events", g_heap_size);
+    for (i = 0; i < g_heap_size; ++i) {
+        PR_DBG("    [%d] id %d deadline %llu period %u func %p user %p", i,
+                g_alarm_heap[i]->id, (unsigned long long)g_alarm_heap[i]->deadline,
+                g_alarm_heap[i]->period, g_alarm_heap[i]->func, g_alarm_heap[i]->user);
+    }
+    PR_DBG("Heap print end.");
 }
 #endif
 
-static void set_alarm(int time) {
-    alarm(time);
-    g_last_set_time = time;
+/*
+ * Heap operations
+ */
+static void heap_swap(int a, int b) {
+    ALARM_EVENT* _tmp = g_alarm_heap[a];
+    g_alarm_heap[a] = g_alarm_heap[b];
+    g_alarm_heap[b] = _tmp;
+    g_alarm_heap[a]->heap_index = a;
+    g_alarm_heap[b]->heap_index = b;
 }
 
-static int find_min_remaining(LIST_ELEMENT* list) {
-    LIST_ELEMENT* _curr;
-    int _min = INT_MAX;
+static void heap_sift_up(int index) {
+    int _parent;
+    while (index > 0) {
+        _parent = (index - 1) >> 1;
+        if (g_alarm_heap[_parent]->deadline <= g_alarm_heap[index]->deadline) {
+            break;
+        }
+        heap_swap(_parent, index);
+        index = _parent;
+    }
+}
 
-    for (_curr = list; _curr; _curr = _curr->next) {
-#define CURR ((ALARM_EVENT*)_curr->content)
-        if (CURR->remaining != 0 && CURR->remaining< _min) {
-            _min = CURR->remaining;
+static void heap_sift_down(int index) {
+    int _child, _min;
+    for (;;) {
+        _min = index;
+        _child = (index << 1) + 1;
+        if (_child < g_heap_size && g_alarm_heap[_child]->deadline < g_alarm_heap[_min]->deadline) {
+            _min = _child;
+        }
+        _child++;
+        if (_child < g_heap_size && g_alarm_heap[_child]->deadline < g_alarm_heap[_min]->deadline) {
+            _min = _child;
         }
+        if (_min == index) {
+            break;
+        }
+        heap_swap(_min, index);
+        index = _min;
+    }
+}
+
+static void heap_insert(ALARM_EVENT* event) {
+    event->heap_index = g_heap_size;
+    g_alarm_heap[g_heap_size++] = event;
+    heap_sift_up(event->heap_index);
+}
+
+static void heap_remove(ALARM_EVENT* event) {
+    int _index = event->heap_index;
+
+    if (--g_heap_size != _index) {
+        heap_swap(_index, g_heap_size);
+        /* The moved one may need to go either way */
+        heap_sift_up(_index);
+        heap_sift_down(g_alarm_heap[_index]->heap_index);
     }
-    return _min;
+    event->heap_index = -1;
 }
 
-static void update_remaining_single(void* alarm_event, void* secs) {
-#define EVENT ((ALARM_EVENT*)alarm_event)
-    EVENT->remaining -= *(int*)secs;
+/*
+ * Point the underlying timer at the nearest deadline, or disarm it if nothing is left
+ */
+static void rearm_timer() {
+#ifdef __linux__
+    struct itimerspec _its = {{0}};
+
+    if (g_timer_func) {
+        g_timer_func(g_heap_size > 0 ? g_alarm_heap[0]->deadline : 0, g_timer_user);
+        return;
+    }
+
+    if (g_heap_size > 0) {
+        uint64_t _deadline = g_alarm_heap[0]->deadline;
+        _its.it_value.tv_sec = _deadline / 1000;
+        _its.it_value.tv_nsec = (_deadline % 1000) * 1000000;
+        if (_its.it_value.tv_sec == 0 && _its.it_value.tv_nsec == 0) {
+            _its.it_value.tv_nsec = 1; /* All zero means disarm */
+        }
+    }
+    timerfd_settime(g_timerfd, TFD_TIMER_ABSTIME, &_its, NULL);
+#else
+    struct itimerval _itv = {{0}};
+
+    if (g_heap_size > 0) {
+        uint64_t _now = now_ms();
+        uint64_t _delta = g_alarm_heap[0]->deadline > _now ? g_alarm_heap[0]->deadline - _now : 1;
+        _itv.it_value.tv_sec = _delta / 1000;
+        _itv.it_value.tv_usec = (_delta % 1000) * 1000;
+    }
+    setitimer(ITIMER_REAL, &_itv, NULL);
+#endif
 }
 
-static void fire_single(void* alarm_event, void* unused) {
-    if (EVENT->remaining <= 0) {
-        EVENT->func(EVENT->user);
+static ALARM_EVENT* alloc_event() {
+    int _slot;
+
+    if (g_free_count < 0) {
+        for (_slot = 0; _slot < ALARM_POOL_SIZE; ++_slot) {
+            g_free_slots[_slot] = ALARM_POOL_SIZE - 1 - _slot;
+        }
+        g_free_count = ALARM_POOL_SIZE;
+    }
+    if (g_free_count == 0) {
+        return NULL;
     }
+
+    _slot = g_free_slots[--g_free_count];
+    ALARM_EVENT* _event = &g_alarm_pool[_slot];
+    if (++_event->generation > ALARM_MAX_GENERATION) {
+        _event->generation = 1;
+    }
+    _event->id = (_event->generation << ALARM_SLOT_BITS) | _slot;
+    return _event;
 }
 
-/* cmpfunc: 0 = match (should be cleaned / not valid), other = unmatch */
-static int alarm_valid_cmpfunc(void* unused, void* alarm_event) {
-    return EVENT->remaining > 0 && EVENT->marked_delete == FALSE;
+static void free_event(ALARM_EVENT* event) {
+    g_free_slots[g_free_count++] = event->id & ALARM_SLOT_MASK;
+    event->id = 0;
+    event->func = NULL;
+    event->user = NULL;
 }
 
-void alarm_sig_handler(int sig) {
+/*
+ * Fire everything due.
+ *
+ * A periodic event is put back before calling its func, so the func could unschedule it.
+ * Its next deadline is the next multiple of period after the original deadline,
+ * thus it does not drift no matter how late we are woken up. Missed periods are skipped.
+ */
+void sched_alarm_ring() {
+    ALARM_EVENT* _event;
+    void (*_func)(void*);
+    void* _user;
+    uint64_t _now = now_ms();
+
     g_ringing = TRUE;
-#ifdef DEBUG
-    PR_DBG("RING!");
-    print_list(&g_alarm_list);
-#endif
+    while (g_heap_size > 0 && g_alarm_heap[0]->deadline <= _now) {
+        _event = g_alarm_heap[0];
+        _func = _event->func;
+        _user = _event->user;
+
+        if (_event->period) {
+            _event->deadline += ((_now - _event->deadline) / _event->period + 1) * _event->period;
+            heap_sift_down(0);
+        } else {
+            heap_remove(_event);
+            free_event(_event);
+        }
 
-    /* We need to avoid maniputing the alarm list during traverse,so
-     * 1. Update all the remaining time fields before calling user func
-     *    to make sure schedule_alarm works.
-     *    Or find_min_remaining in user func may return some value that
-     *    will expire just in this triggered alarm.
-     * 2. Call user func, and prevent removing/adding nodes during this process.
-     *    This will ensure the list's integrity during traversing.
-     * 3. Apply deletion / insertion, clean up expired alarms.
-     */
-    list_traverse(g_alarm_list, update_remaining_single, &g_last_set_time);
-    list_traverse(g_alarm_list, fire_single, NULL);
-
-    /* Clean up expired and mark-as-delete alarms */
-    remove_data(&g_alarm_list, NULL, alarm_valid_cmpfunc, TRUE);
-
-    /* Append newly scheduled alarms */
-    list_concat(&g_alarm_list, g_alarm_list_add_temp);
-    /* Prepare for further new lists */
-    g_alarm_list_add_temp = NULL;
-
-    int _curr_remaining = find_min_remaining(g_alarm_list);
-    set_alarm(_curr_remaining);
+        _func(_user);
+        _now = now_ms();
+    }
+    g_ringing = FALSE;
 
 #ifdef DEBUG
-    PR_DBG("RING END!");
-    print_list(&g_alarm_list);
+    print_heap();
 #endif
-    g_ringing = FALSE;
+    rearm_timer();
+}
+
+#ifdef __linux__
+static void alarm_timerfd_handler(int fd, void* unused) {
+    uint64_t _expirations;
+
+    /* May fail with EAGAIN if re-armed before we get here. Check the heap anyway */
+    read(fd, &_expirations, sizeof(_expirations));
+    sched_alarm_ring();
 }
 
 RESULT sched_alarm_init() {
-    signal(SIGALRM, alarm_sig_handler);
-    return SUCCESS;
+    if ((g_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+        PR_ERRNO("timerfd 创建失败");
+        return FAILURE;
+    }
+    return event_loop_add_fd(g_timerfd, alarm_timerfd_handler, NULL);
 }
 
-void sched_alarm_destroy() {
-    list_destroy(&g_alarm_list, TRUE);
-    alarm(0);
+void sched_alarm_set_timer_func(void (*func)(uint64_t deadline_ms, void* user), void* user) {
+    struct itimerspec _its = {{0}};
+
+    if (func != NULL && g_timerfd >= 0) {
+        timerfd_settime(g_timerfd, 0, &_its, NULL); /* Stays quiet until we are back */
+    }
+    g_timer_func = func;
+    g_timer_user = user;
+    if (g_timerfd >= 0) {
+        rearm_timer();
+    }
 }
 
-static void alarm_mark_as_delete_single(void* alarm_event, void* id) {
-    if (EVENT->id == *(int*)id) {
-        EVENT->marked_delete = TRUE;
+void sched_alarm_destroy() {
+    g_timer_func = NULL;
+    while (g_heap_size > 0) {
+        free_event(g_alarm_heap[--g_heap_size]);
+    }
+    if (g_timerfd >= 0) {
+        event_loop_remove_fd(g_timerfd);
+        close(g_timerfd);
+        g_timerfd = -1;
     }
 }
+#else
+static void alarm_sig_handler(int sig) {
+    sched_alarm_ring();
+}
+
+RESULT sched_alarm_init() {
+    signal(SIGALRM, alarm_sig_handler);
+    return SUCCESS;
+}
 
-static int alarm_event_id_node_cmpfunc(void* id, void* node) {
-    if (*(int*)id == ((ALARM_EVENT*)node)->id) {
-        return 0;
+void sched_alarm_destroy() {
+    while (g_heap_size > 0) {
+        free_event(g_alarm_heap[--g_heap_size]);
     }
-    return 1;
+    rearm_timer();
 }
+#endif
 
 void unschedule_alarm(int id) {
-    if (g_ringing) {
-        list_traverse(g_alarm_list, alarm_mark_as_delete_single, &id);
-#ifdef DEBUG
-        PR_DBG("Marked event id = %d as deletion", id);
-        print_list(&g_alarm_list);
-#endif
-    } else {
-        remove_data(&g_alarm_list, &id, alarm_event_id_node_cmpfunc, TRUE);
+    ALARM_EVENT* _event;
+
+    if (id <= 0) return;
+
+    ALARM_LOCK();
+    _event = &g_alarm_pool[id & ALARM_SLOT_MASK];
+    if (_event->id == id) {
+        heap_remove(_event);
+        free_event(_event);
 #ifdef DEBUG
         PR_DBG("Removed event id = %d", id);
-        print_list(&g_alarm_list);
+        print_heap();
 #endif
+        if (!g_ringing) {
+            rearm_timer();
+        }
     }
+    ALARM_UNLOCK();
 }
 
-int schedule_alarm(int secs, void (*func)(void*), void* user) {
-    ALARM_EVENT* _event = (ALARM_EVENT*)malloc(sizeof(ALARM_EVENT));
-    if (_event == NULL) {
-        PR_ERR("无法为闹钟事件分配内存");
+int schedule_periodic_alarm_ms(int first_msecs, int period_msecs, void (*func)(void*), void* user) {
+    ALARM_EVENT* _event;
+
+    ALARM_LOCK();
+    if ((_event = alloc_event()) == NULL) {
+        ALARM_UNLOCK();
+        PR_ERR("闹钟事件过多，无法添加新事件");
         return -1;
     }
-    _event->remaining = secs;
-    _event->id = ++g_last_id;
+
+    _event->deadline = now_ms() + (first_msecs > 0 ? first_msecs : 0);
+    _event->period = period_msecs > 0 ? period_msecs : 0;
     _event->func = func;
     _event->user = user;
-    _event->marked_delete = FALSE;
+    heap_insert(_event);
 
-    if (g_ringing) {
-        /* It's ringing. Do not reset alarm here. The signal handler will do this */
-        insert_data(&g_alarm_list_add_temp, _event);
 #ifdef DEBUG
-        PR_DBG("Pending new alarm event insertion");
-        print_list(&g_alarm_list_add_temp);
-#endif
-    } else {
-        /* Not ringing. Time to next alarm should be obtained by alarm(0) */
-        int _curr_remaining = alarm(0);
-        /* When there is no alarm set, alarm(0) would be 0. Fix to INT_MAX for comparsion */
-        if (_curr_remaining == 0) _curr_remaining = INT_MAX;
-        /* Reset since we stopped the alarm half way. */
-        set_alarm(_curr_remaining < secs ? _curr_remaining : secs);
-        insert_data(&g_alarm_list, _event);
-#ifdef DEBUG
-        PR_DBG("New alarm event added");
-        print_list(&g_alarm_list);
+    PR_DBG("New alarm event added");
+    print_heap();
 #endif
+    /* The signal handler / timerfd handler will do this after ringing */
+    if (!g_ringing && _event->heap_index == 0) {
+        rearm_timer();
     }
+    ALARM_UNLOCK();
     return _event->id;
 }
+
+int schedule_alarm_ms(int msecs, void (*func)(void*), void* user) {
+    return schedule_periodic_alarm_ms(msecs, 0, func, user);
+}
+
+int schedule_alarm(int secs, void (*func)(void*), void* user) {
+    return schedule_alarm_ms(secs * 1000, func, user);
+}